@@ -0,0 +1,264 @@
+// Offline benchmark of the azure extension: the blobs are served from local files by MockHttpTransport, so the runs
+// only depend on the simulated latency, bandwidth and errors.
+//
+// Usage: azure_benchmark [--data-dir DIR] [--scenario NAME] [--repeat N] [--latency-ms N] [--bandwidth-mbps N]
+//                        [--error-rate R] [--setting NAME=VALUE]...
+//
+// The buffered_reads scenario reads a file sequentially through the FileSystem API with several read sizes and
+// reports the bytes copied from the read buffer per byte delivered to the reader (copy_ratio).
+
+#include "azure_http_state.hpp"
+#include "azure_storage_account_client.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_helper.hpp"
+#include "mock_http_transport.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace duckdb;
+
+static constexpr const char *CONTAINER = "bench";
+
+struct BenchmarkScenario {
+	const char *name;
+	const char *description;
+	//! Query of the scenario, {} is replaced by the azure:// path of the container. nullptr for buffered_reads
+	const char *query;
+};
+
+static const BenchmarkScenario SCENARIOS[] = {
+    {"csv_scan", "sequential scan of a 1M rows CSV", "SELECT count(*), sum(b) FROM read_csv('{}/csv/data.csv')"},
+    {"parquet_projection", "one column out of 16 of a 1M rows Parquet",
+     "SELECT sum(c7) FROM read_parquet('{}/parquet/data.parquet')"},
+    {"glob_10k", "glob over 10k files in 100 directories", "SELECT count(*) FROM glob('{}/glob/*/*.csv')"},
+    {"small_files", "read of 2000 CSV files of ~2KiB", "SELECT count(*), sum(a) FROM read_csv('{}/small/*.csv')"},
+    {"buffered_reads", "sequential reads of the CSV file with several read sizes", nullptr},
+};
+
+//! Read sizes of the buffered_reads scenario, around the default read buffer size (1MiB)
+static const idx_t BUFFERED_READ_SIZES[] = {4 * 1024, 256 * 1024, 1024 * 1024 - 1, 1024 * 1024 + 4096,
+                                            4 * 1024 * 1024 + 1000};
+
+struct BenchmarkConfig {
+	std::string data_directory = "azure_benchmark_data";
+	std::string scenario;
+	idx_t repeat = 3;
+	MockTransportOptions transport;
+	vector<std::pair<std::string, std::string>> settings;
+};
+
+static void Usage() {
+	std::cerr << "Usage: azure_benchmark [--data-dir DIR] [--scenario NAME] [--repeat N] [--latency-ms N] "
+	             "[--bandwidth-mbps N] [--error-rate R] [--setting NAME=VALUE]...\n\nScenarios:\n";
+	for (const auto &scenario : SCENARIOS) {
+		std::cerr << "  " << scenario.name << ": " << scenario.description << "\n";
+	}
+	exit(1);
+}
+
+static BenchmarkConfig ParseArguments(int argc, char **argv) {
+	BenchmarkConfig config;
+	config.transport.latency_us = 20 * 1000;
+	config.transport.bandwidth_bytes_per_sec = 100 * 1024 * 1024;
+	for (int arg_idx = 1; arg_idx < argc; arg_idx++) {
+		std::string arg = argv[arg_idx];
+		if (arg_idx + 1 >= argc) {
+			Usage();
+		}
+		std::string value = argv[++arg_idx];
+		if (arg == "--data-dir") {
+			config.data_directory = value;
+		} else if (arg == "--scenario") {
+			config.scenario = value;
+		} else if (arg == "--repeat") {
+			config.repeat = std::stoull(value);
+		} else if (arg == "--latency-ms") {
+			config.transport.latency_us = static_cast<idx_t>(std::stod(value) * 1000);
+		} else if (arg == "--bandwidth-mbps") {
+			config.transport.bandwidth_bytes_per_sec = static_cast<idx_t>(std::stod(value) * 1024 * 1024);
+		} else if (arg == "--error-rate") {
+			config.transport.error_rate = std::stod(value);
+		} else if (arg == "--setting") {
+			auto separator = value.find('=');
+			if (separator == std::string::npos) {
+				Usage();
+			}
+			config.settings.emplace_back(value.substr(0, separator), value.substr(separator + 1));
+		} else {
+			Usage();
+		}
+	}
+	return config;
+}
+
+static void WriteFile(FileSystem &fs, const std::string &path, const std::string &content) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write((void *)content.data(), content.size());
+}
+
+static void Query(Connection &con, const std::string &query) {
+	auto result = con.Query(query);
+	if (result->HasError()) {
+		throw IOException("Query '%s' failed: %s", query, result->GetError());
+	}
+}
+
+//! Generate the blobs of the scenarios once, a later run reuses them
+static void GenerateData(const std::string &data_directory) {
+	auto fs = FileSystem::CreateLocal();
+	auto container_directory = fs->JoinPath(data_directory, CONTAINER);
+	if (fs->DirectoryExists(container_directory)) {
+		return;
+	}
+	std::cerr << "Generating the benchmark data in " << container_directory << "\n";
+	fs->CreateDirectory(data_directory);
+	fs->CreateDirectory(container_directory);
+	for (auto directory : {"csv", "parquet", "glob", "small"}) {
+		fs->CreateDirectory(fs->JoinPath(container_directory, directory));
+	}
+
+	DuckDB db(nullptr);
+	ExtensionHelper::LoadAllExtensions(db);
+	Connection con(db);
+	Query(con, StringUtil::Format("COPY (SELECT i AS a, i * 7 %% 1000 AS b, 'value_' || i AS c, i / 3.0 AS d FROM "
+	                              "range(1000000) t(i)) TO '%s' (FORMAT CSV, HEADER)",
+	                              fs->JoinPath(container_directory, "csv/data.csv")));
+	std::string columns;
+	for (idx_t column_idx = 0; column_idx < 16; column_idx++) {
+		columns += StringUtil::Format("%si * %llu AS c%llu", column_idx ? ", " : "", column_idx + 1, column_idx);
+	}
+	Query(con, StringUtil::Format("COPY (SELECT %s FROM range(1000000) t(i)) TO '%s' (FORMAT PARQUET, "
+	                              "ROW_GROUP_SIZE 100000)",
+	                              columns, fs->JoinPath(container_directory, "parquet/data.parquet")));
+
+	auto glob_directory = fs->JoinPath(container_directory, "glob");
+	for (idx_t directory_idx = 0; directory_idx < 100; directory_idx++) {
+		auto directory = fs->JoinPath(glob_directory, StringUtil::Format("d%03llu", directory_idx));
+		fs->CreateDirectory(directory);
+		for (idx_t file_idx = 0; file_idx < 100; file_idx++) {
+			WriteFile(*fs, fs->JoinPath(directory, StringUtil::Format("f%03llu.csv", file_idx)), "a\n1\n");
+		}
+	}
+
+	auto small_directory = fs->JoinPath(container_directory, "small");
+	for (idx_t file_idx = 0; file_idx < 2000; file_idx++) {
+		std::string content = "a,b\n";
+		for (idx_t row_idx = 0; row_idx < 200; row_idx++) {
+			content += std::to_string(file_idx * 200 + row_idx) + ",x\n";
+		}
+		WriteFile(*fs, fs->JoinPath(small_directory, StringUtil::Format("f%04llu.csv", file_idx)), content);
+	}
+}
+
+static void PrintResult(const std::string &name, idx_t run, int64_t wall_ms, const MockTransportStats &stats,
+                        const std::string &copy_ratio) {
+	printf("%-26s %4llu %10lld %9llu %7llu %7llu %7llu %7llu %14llu %10s\n", name.c_str(),
+	       static_cast<unsigned long long>(run), static_cast<long long>(wall_ms),
+	       static_cast<unsigned long long>(stats.request_count), static_cast<unsigned long long>(stats.head_count),
+	       static_cast<unsigned long long>(stats.get_count), static_cast<unsigned long long>(stats.list_count),
+	       static_cast<unsigned long long>(stats.error_count), static_cast<unsigned long long>(stats.bytes_sent),
+	       copy_ratio.c_str());
+	fflush(stdout);
+}
+
+static void ApplySettings(const BenchmarkConfig &config, Connection &con) {
+	Query(con, "SET azure_account_name = 'benchmark'");
+	for (const auto &setting : config.settings) {
+		Query(con, StringUtil::Format("SET %s = '%s'", setting.first, setting.second));
+	}
+}
+
+static void RunBufferedReads(const BenchmarkConfig &config, MockHttpTransport &transport) {
+	auto path = std::string("azure://") + CONTAINER + "/csv/data.csv";
+	for (auto read_size : BUFFERED_READ_SIZES) {
+		auto name = StringUtil::Format("buffered_reads/%llu", read_size);
+		for (idx_t run = 0; run < config.repeat; run++) {
+			DuckDB db(nullptr);
+			ExtensionHelper::LoadAllExtensions(db);
+			Connection con(db);
+			ApplySettings(config, con);
+			// Not a query: open a transaction like a query would, for the secret and setting lookups
+			con.BeginTransaction();
+
+			transport.Reset();
+			auto start_time = std::chrono::steady_clock::now();
+			auto &fs = FileSystem::GetFileSystem(*con.context);
+			auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+			auto file_size = static_cast<idx_t>(handle->GetFileSize());
+			auto buffer = duckdb::unique_ptr<data_t[]>(new data_t[read_size]);
+			idx_t delivered = 0;
+			while (delivered < file_size) {
+				auto length = MinValue<idx_t>(read_size, file_size - delivered);
+				handle->Read(buffer.get(), length);
+				delivered += length;
+			}
+			handle.reset();
+			auto wall_time =
+			    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+
+			auto http_state = AzureHTTPState::TryGetState(*con.context);
+			auto copied = http_state ? static_cast<idx_t>(http_state->read_buffer_copy_bytes) : 0;
+			con.Commit();
+			PrintResult(name, run, wall_time.count(), transport.GetStats(),
+			            StringUtil::Format("%.3f", static_cast<double>(copied) / static_cast<double>(delivered)));
+		}
+	}
+}
+
+static void RunScenario(const BenchmarkConfig &config, const BenchmarkScenario &scenario,
+                        MockHttpTransport &transport) {
+	if (!scenario.query) {
+		RunBufferedReads(config, transport);
+		return;
+	}
+	auto query = StringUtil::Replace(scenario.query, "{}", std::string("azure://") + CONTAINER);
+	for (idx_t run = 0; run < config.repeat; run++) {
+		// A fresh database per run, nothing is cached from a previous run
+		DuckDB db(nullptr);
+		ExtensionHelper::LoadAllExtensions(db);
+		Connection con(db);
+		ApplySettings(config, con);
+
+		transport.Reset();
+		auto start_time = std::chrono::steady_clock::now();
+		auto result = con.Query(query);
+		auto wall_time =
+		    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+		if (result->HasError()) {
+			std::cerr << scenario.name << " failed: " << result->GetError() << "\n";
+			exit(1);
+		}
+		PrintResult(scenario.name, run, wall_time.count(), transport.GetStats(), "-");
+	}
+}
+
+int main(int argc, char **argv) {
+	auto config = ParseArguments(argc, argv);
+	GenerateData(config.data_directory);
+
+	config.transport.root_directory = config.data_directory;
+	auto transport = std::make_shared<MockHttpTransport>(config.transport);
+	SetAzureTransportOverride(transport);
+
+	printf("%-26s %4s %10s %9s %7s %7s %7s %7s %14s %10s\n", "scenario", "run", "wall_ms", "requests", "head", "get",
+	       "list", "errors", "bytes", "copy_ratio");
+	bool found = false;
+	for (const auto &scenario : SCENARIOS) {
+		if (!config.scenario.empty() && config.scenario != scenario.name) {
+			continue;
+		}
+		found = true;
+		RunScenario(config, scenario, *transport);
+	}
+	SetAzureTransportOverride(nullptr);
+	if (!found) {
+		Usage();
+	}
+	return 0;
+}
@@ -0,0 +1,372 @@
+#include "mock_http_transport.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include <azure/core/datetime.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/core/url.hpp>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace duckdb {
+
+using Azure::Core::Http::HttpMethod;
+using Azure::Core::Http::HttpStatusCode;
+using Azure::Core::Http::RawResponse;
+
+//! Body stream owning its bytes, the reads are slowed down to the configured bandwidth
+class MockBodyStream : public Azure::Core::IO::BodyStream {
+public:
+	MockBodyStream(std::vector<uint8_t> data, idx_t bandwidth_bytes_per_sec)
+	    : data(std::move(data)), bandwidth_bytes_per_sec(bandwidth_bytes_per_sec), position(0),
+	      start_time(std::chrono::steady_clock::now()) {
+	}
+
+	int64_t Length() const override {
+		return static_cast<int64_t>(data.size());
+	}
+
+	void Rewind() override {
+		position = 0;
+		start_time = std::chrono::steady_clock::now();
+	}
+
+private:
+	size_t OnRead(uint8_t *buffer, size_t count, Azure::Core::Context const &context) override {
+		static constexpr idx_t MAX_READ_SIZE = 64 * 1024;
+		auto read_size = MinValue<idx_t>(MinValue<idx_t>(count, MAX_READ_SIZE), data.size() - position);
+		if (read_size == 0) {
+			return 0;
+		}
+		if (bandwidth_bytes_per_sec > 0) {
+			auto ready_at = start_time + std::chrono::microseconds((position + read_size) * 1000000 /
+			                                                       bandwidth_bytes_per_sec);
+			while (std::chrono::steady_clock::now() < ready_at) {
+				context.ThrowIfCancelled();
+				std::this_thread::sleep_for(MinValue<std::chrono::steady_clock::duration>(
+				    ready_at - std::chrono::steady_clock::now(), std::chrono::milliseconds(1)));
+			}
+		}
+		memcpy(buffer, data.data() + position, read_size);
+		position += read_size;
+		return read_size;
+	}
+
+private:
+	std::vector<uint8_t> data;
+	const idx_t bandwidth_bytes_per_sec;
+	idx_t position;
+	std::chrono::steady_clock::time_point start_time;
+};
+
+static std::string EscapeXml(const std::string &value) {
+	std::string result;
+	for (auto c : value) {
+		switch (c) {
+		case '&':
+			result += "&amp;";
+			break;
+		case '<':
+			result += "&lt;";
+			break;
+		case '>':
+			result += "&gt;";
+			break;
+		default:
+			result += c;
+		}
+	}
+	return result;
+}
+
+static std::string GetQueryParameter(const Azure::Core::Http::Request &request, const std::string &name) {
+	auto parameters = request.GetUrl().GetQueryParameters();
+	auto entry = parameters.find(name);
+	if (entry == parameters.end()) {
+		return std::string();
+	}
+	return Azure::Core::Url::Decode(entry->second);
+}
+
+MockHttpTransport::MockHttpTransport(MockTransportOptions options_p)
+    : options(std::move(options_p)), random(options.seed) {
+	Reset();
+	LoadBlobs();
+}
+
+void MockHttpTransport::LoadBlobs() {
+	auto fs = FileSystem::CreateLocal();
+	std::function<void(const std::string &, const std::string &, map<std::string, BlobEntry> &)> load_directory;
+	load_directory = [&](const std::string &directory, const std::string &name_prefix,
+	                     map<std::string, BlobEntry> &blobs) {
+		fs->ListFiles(directory, [&](const string &name, bool is_directory) {
+			auto path = fs->JoinPath(directory, name);
+			if (is_directory) {
+				load_directory(path, name_prefix + name + '/', blobs);
+				return;
+			}
+			auto handle = fs->OpenFile(path, FileFlags::FILE_FLAGS_READ);
+			auto size = static_cast<idx_t>(fs->GetFileSize(*handle));
+			auto last_modified = fs->GetLastModifiedTime(*handle);
+			auto fingerprint = std::to_string(size) + ';' + std::to_string(last_modified);
+			auto etag = StringUtil::Format("%016llx", Hash(fingerprint.c_str(), fingerprint.size()));
+			Azure::DateTime modified_on(std::chrono::system_clock::from_time_t(last_modified));
+			blobs[name_prefix + name] = BlobEntry {size, modified_on.ToString(Azure::DateTime::DateFormat::Rfc1123),
+			                                       "\"0x" + StringUtil::Upper(etag) + "\""};
+		});
+	};
+
+	fs->ListFiles(options.root_directory, [&](const string &name, bool is_directory) {
+		if (is_directory) {
+			load_directory(fs->JoinPath(options.root_directory, name), std::string(), containers[name]);
+		}
+	});
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::Send(Azure::Core::Http::Request &request,
+                                                     Azure::Core::Context const &context) {
+	request_count++;
+	Wait(options.latency_us, context);
+	if (InjectError()) {
+		error_count++;
+		auto response = Error(HttpStatusCode::ServiceUnavailable, "ServerBusy");
+		response->SetHeader("x-ms-retry-after-ms", std::to_string(options.retry_after_ms));
+		return response;
+	}
+
+	// The path is <container>/<blob name>, the account is not part of it
+	auto path = Azure::Core::Url::Decode(request.GetUrl().GetPath());
+	auto separator = path.find('/');
+	auto container_name = path.substr(0, separator);
+	auto blob_name = separator == std::string::npos ? std::string() : path.substr(separator + 1);
+
+	auto container = containers.find(container_name);
+	if (container == containers.end()) {
+		return Error(HttpStatusCode::NotFound, "ContainerNotFound");
+	}
+
+	const auto &method = request.GetMethod();
+	if (method == HttpMethod::Get && GetQueryParameter(request, "comp") == "list") {
+		list_count++;
+		return List(request, container_name);
+	}
+	if (method != HttpMethod::Head && method != HttpMethod::Get) {
+		return Error(HttpStatusCode::MethodNotAllowed, "UnsupportedHttpVerb");
+	}
+
+	auto blob = container->second.find(blob_name);
+	if (method == HttpMethod::Head) {
+		head_count++;
+		if (blob == container->second.end()) {
+			return Error(HttpStatusCode::NotFound, "BlobNotFound");
+		}
+		return GetProperties(blob->second);
+	}
+	auto download_count = ++get_count;
+	if (blob == container->second.end()) {
+		return Error(HttpStatusCode::NotFound, "BlobNotFound");
+	}
+	if (options.slow_download_interval > 0 && download_count % options.slow_download_interval == 0) {
+		Wait(options.slow_download_latency_us, context);
+	}
+	return Download(request, container_name, blob_name, blob->second);
+}
+
+bool MockHttpTransport::InjectError() {
+	if (options.error_rate <= 0) {
+		return false;
+	}
+	lock_guard<mutex> guard(random_lock);
+	return std::uniform_real_distribution<double>(0, 1)(random) < options.error_rate;
+}
+
+void MockHttpTransport::Wait(idx_t duration_us, Azure::Core::Context const &context) const {
+	auto ready_at = std::chrono::steady_clock::now() + std::chrono::microseconds(duration_us);
+	// Sleep by small steps so a cancelled request (e.g. a hedged read that lost) does not hold its thread
+	while (std::chrono::steady_clock::now() < ready_at) {
+		context.ThrowIfCancelled();
+		std::this_thread::sleep_for(MinValue<std::chrono::steady_clock::duration>(
+		    ready_at - std::chrono::steady_clock::now(), std::chrono::milliseconds(1)));
+	}
+}
+
+static void SetBlobHeaders(RawResponse &response, const std::string &last_modified, const std::string &etag) {
+	response.SetHeader("Last-Modified", last_modified);
+	response.SetHeader("ETag", etag);
+	response.SetHeader("x-ms-creation-time", last_modified);
+	response.SetHeader("x-ms-blob-type", "BlockBlob");
+	response.SetHeader("x-ms-server-encrypted", "true");
+	response.SetHeader("x-ms-lease-state", "available");
+	response.SetHeader("x-ms-lease-status", "unlocked");
+	response.SetHeader("Accept-Ranges", "bytes");
+	response.SetHeader("Content-Type", "application/octet-stream");
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::GetProperties(const BlobEntry &blob) {
+	auto response = std::unique_ptr<RawResponse>(new RawResponse(1, 1, HttpStatusCode::Ok, "OK"));
+	SetBlobHeaders(*response, blob.last_modified, blob.etag);
+	auto result = WithBody(std::move(response), std::vector<uint8_t>());
+	// A HEAD response has no body but announces the size of the blob
+	result->SetHeader("Content-Length", std::to_string(blob.size));
+	return result;
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::Download(Azure::Core::Http::Request &request,
+                                                         const std::string &container, const std::string &name,
+                                                         const BlobEntry &blob) {
+	idx_t start = 0;
+	idx_t end = blob.size;
+	auto range = request.GetHeader("x-ms-range");
+	if (!range.HasValue()) {
+		range = request.GetHeader("Range");
+	}
+	if (range.HasValue()) {
+		// bytes=<first>-[<last>]
+		auto bounds = range.Value().substr(range.Value().find('=') + 1);
+		auto dash = bounds.find('-');
+		start = std::stoull(bounds.substr(0, dash));
+		if (dash + 1 < bounds.size()) {
+			end = MinValue<idx_t>(std::stoull(bounds.substr(dash + 1)) + 1, blob.size);
+		}
+		if (start >= blob.size) {
+			auto response = Error(HttpStatusCode::RangeNotSatisfiable, "InvalidRange");
+			response->SetHeader("Content-Range", "bytes */" + std::to_string(blob.size));
+			return response;
+		}
+	}
+
+	std::vector<uint8_t> body(end - start);
+	if (!body.empty()) {
+		auto fs = FileSystem::CreateLocal();
+		auto path = fs->JoinPath(fs->JoinPath(options.root_directory, container), name);
+		auto handle = fs->OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		handle->Read(body.data(), body.size(), start);
+	}
+
+	std::unique_ptr<RawResponse> response;
+	if (range.HasValue()) {
+		response.reset(new RawResponse(1, 1, HttpStatusCode::PartialContent, "Partial Content"));
+		response->SetHeader("Content-Range", "bytes " + std::to_string(start) + '-' + std::to_string(end - 1) + '/' +
+		                                         std::to_string(blob.size));
+	} else {
+		response.reset(new RawResponse(1, 1, HttpStatusCode::Ok, "OK"));
+	}
+	SetBlobHeaders(*response, blob.last_modified, blob.etag);
+	bytes_sent += body.size();
+	return WithBody(std::move(response), std::move(body));
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::List(Azure::Core::Http::Request &request,
+                                                     const std::string &container) {
+	auto prefix = GetQueryParameter(request, "prefix");
+	auto delimiter = GetQueryParameter(request, "delimiter");
+	auto marker = GetQueryParameter(request, "marker");
+	auto page_size = options.list_page_size;
+	auto max_results = GetQueryParameter(request, "maxresults");
+	if (!max_results.empty()) {
+		page_size = MinValue<idx_t>(page_size, std::stoull(max_results));
+	}
+
+	// Names below the delimiter are folded in their prefix, both kinds are ordered together like the service does
+	struct ListEntry {
+		std::string name;
+		const BlobEntry *blob;
+	};
+	vector<ListEntry> entries;
+	const auto &blobs = containers.at(container);
+	for (auto it = blobs.lower_bound(prefix); it != blobs.end() && StringUtil::StartsWith(it->first, prefix); it++) {
+		auto delimiter_pos = delimiter.empty() ? std::string::npos : it->first.find(delimiter, prefix.size());
+		if (delimiter_pos == std::string::npos) {
+			entries.push_back(ListEntry {it->first, &it->second});
+			continue;
+		}
+		auto blob_prefix = it->first.substr(0, delimiter_pos + delimiter.size());
+		if (entries.empty() || entries.back().name != blob_prefix) {
+			entries.push_back(ListEntry {blob_prefix, nullptr});
+		}
+	}
+
+	std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+	                  "ServiceEndpoint=\"https://mock.blob.core.windows.net/\" ContainerName=\"" +
+	                  EscapeXml(container) + "\"><Prefix>" + EscapeXml(prefix) + "</Prefix><MaxResults>" +
+	                  std::to_string(page_size) + "</MaxResults>";
+	if (!delimiter.empty()) {
+		xml += "<Delimiter>" + EscapeXml(delimiter) + "</Delimiter>";
+	}
+	xml += "<Blobs>";
+	idx_t entry_idx = 0;
+	while (entry_idx < entries.size() && entries[entry_idx].name < marker) {
+		entry_idx++;
+	}
+	for (idx_t count = 0; entry_idx < entries.size() && count < page_size; entry_idx++, count++) {
+		const auto &entry = entries[entry_idx];
+		if (!entry.blob) {
+			xml += "<BlobPrefix><Name>" + EscapeXml(entry.name) + "</Name></BlobPrefix>";
+			continue;
+		}
+		xml += "<Blob><Name>" + EscapeXml(entry.name) + "</Name><Properties><Creation-Time>" +
+		       entry.blob->last_modified + "</Creation-Time><Last-Modified>" + entry.blob->last_modified +
+		       "</Last-Modified><Etag>" + EscapeXml(entry.blob->etag) + "</Etag><Content-Length>" +
+		       std::to_string(entry.blob->size) +
+		       "</Content-Length><Content-Type>application/octet-stream</Content-Type><BlobType>BlockBlob</BlobType>"
+		       "<AccessTier>Hot</AccessTier><AccessTierInferred>true</AccessTierInferred><LeaseStatus>unlocked"
+		       "</LeaseStatus><LeaseState>available</LeaseState><ServerEncrypted>true</ServerEncrypted></Properties>"
+		       "</Blob>";
+	}
+	xml += "</Blobs>";
+	if (entry_idx < entries.size()) {
+		xml += "<NextMarker>" + EscapeXml(entries[entry_idx].name) + "</NextMarker>";
+	} else {
+		xml += "<NextMarker />";
+	}
+	xml += "</EnumerationResults>";
+
+	auto response = std::unique_ptr<RawResponse>(new RawResponse(1, 1, HttpStatusCode::Ok, "OK"));
+	response->SetHeader("Content-Type", "application/xml");
+	bytes_sent += xml.size();
+	return WithBody(std::move(response), std::vector<uint8_t>(xml.begin(), xml.end()));
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::Error(HttpStatusCode status, const std::string &code) {
+	auto response = std::unique_ptr<RawResponse>(new RawResponse(1, 1, status, code));
+	response->SetHeader("x-ms-error-code", code);
+	response->SetHeader("Content-Type", "application/xml");
+	std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Error><Code>" + code + "</Code><Message>" + code +
+	                  "</Message></Error>";
+	return WithBody(std::move(response), std::vector<uint8_t>(xml.begin(), xml.end()));
+}
+
+std::unique_ptr<RawResponse> MockHttpTransport::WithBody(std::unique_ptr<RawResponse> response,
+                                                         std::vector<uint8_t> body) {
+	response->SetHeader("Content-Length", std::to_string(body.size()));
+	response->SetHeader("x-ms-request-id", std::to_string(request_count.load()));
+	response->SetHeader("x-ms-version", "2023-11-03");
+	response->SetBodyStream(std::unique_ptr<Azure::Core::IO::BodyStream>(
+	    new MockBodyStream(std::move(body), options.bandwidth_bytes_per_sec)));
+	return response;
+}
+
+MockTransportStats MockHttpTransport::GetStats() const {
+	MockTransportStats stats;
+	stats.request_count = request_count;
+	stats.head_count = head_count;
+	stats.get_count = get_count;
+	stats.list_count = list_count;
+	stats.error_count = error_count;
+	stats.bytes_sent = bytes_sent;
+	return stats;
+}
+
+void MockHttpTransport::Reset() {
+	request_count = 0;
+	head_count = 0;
+	get_count = 0;
+	list_count = 0;
+	error_count = 0;
+	bytes_sent = 0;
+}
+
+} // namespace duckdb
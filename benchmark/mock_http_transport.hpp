@@ -0,0 +1,98 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/types.hpp"
+#include <azure/core/http/http.hpp>
+#include <azure/core/http/transport.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace duckdb {
+
+struct MockTransportOptions {
+	//! Directory served, its sub directories are the containers and the files below them the blobs
+	std::string root_directory;
+	//! Delay before the response headers are returned
+	idx_t latency_us = 0;
+	//! Bandwidth of each response body, 0 for unlimited
+	idx_t bandwidth_bytes_per_sec = 0;
+	//! Probability (0-1) of a request to fail with a 503 ServerBusy before it reaches the blob
+	double error_rate = 0;
+	//! Retry delay advertised by the injected errors
+	idx_t retry_after_ms = 10;
+	//! Every slow_download_interval-th download waits slow_download_latency_us more before its response, e.g. to
+	//! trigger the hedging. 0 for none
+	idx_t slow_download_interval = 0;
+	idx_t slow_download_latency_us = 0;
+	//! Number of entries in a page of a listing when the request does not ask for less
+	idx_t list_page_size = 5000;
+	uint32_t seed = 42;
+};
+
+//! What the transport has served since its last Reset
+struct MockTransportStats {
+	idx_t request_count = 0;
+	idx_t head_count = 0;
+	idx_t get_count = 0;
+	idx_t list_count = 0;
+	idx_t error_count = 0;
+	idx_t bytes_sent = 0;
+};
+
+//! In-process Azure blob endpoint backed by local files. It answers GetProperties, ranged downloads and (hierarchical)
+//! listings of any account, so the extension can be exercised and measured without Azurite or a storage account.
+class MockHttpTransport : public Azure::Core::Http::HttpTransport {
+public:
+	explicit MockHttpTransport(MockTransportOptions options);
+
+public:
+	std::unique_ptr<Azure::Core::Http::RawResponse> Send(Azure::Core::Http::Request &request,
+	                                                     Azure::Core::Context const &context) override;
+
+	MockTransportStats GetStats() const;
+	void Reset();
+
+private:
+	struct BlobEntry {
+		idx_t size;
+		std::string last_modified;
+		std::string etag;
+	};
+
+	//! Index the blobs of the root directory
+	void LoadBlobs();
+	bool InjectError();
+	void Wait(idx_t duration_us, Azure::Core::Context const &context) const;
+
+	std::unique_ptr<Azure::Core::Http::RawResponse> GetProperties(const BlobEntry &blob);
+	std::unique_ptr<Azure::Core::Http::RawResponse> Download(Azure::Core::Http::Request &request,
+	                                                         const std::string &container, const std::string &name,
+	                                                         const BlobEntry &blob);
+	std::unique_ptr<Azure::Core::Http::RawResponse> List(Azure::Core::Http::Request &request,
+	                                                     const std::string &container);
+	std::unique_ptr<Azure::Core::Http::RawResponse> Error(Azure::Core::Http::HttpStatusCode status,
+	                                                      const std::string &code);
+	std::unique_ptr<Azure::Core::Http::RawResponse> WithBody(std::unique_ptr<Azure::Core::Http::RawResponse> response,
+	                                                         std::vector<uint8_t> body);
+
+private:
+	const MockTransportOptions options;
+	//! container -> blob name -> blob, names are ordered like the listings of the service
+	map<std::string, map<std::string, BlobEntry>> containers;
+
+	mutex random_lock;
+	std::mt19937 random;
+
+	atomic<idx_t> request_count;
+	atomic<idx_t> head_count;
+	atomic<idx_t> get_count;
+	atomic<idx_t> list_count;
+	atomic<idx_t> error_count;
+	atomic<idx_t> bytes_sent;
+};
+
+} // namespace duckdb
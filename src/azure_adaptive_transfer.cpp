@@ -0,0 +1,117 @@
+#include "azure_adaptive_transfer.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+//! Weight of the last download in the throughput moving average
+static constexpr double THROUGHPUT_SMOOTHING = 0.25;
+//! A download slower than this fraction of the average throughput is a congestion signal
+static constexpr double THROUGHPUT_DEGRADATION = 0.8;
+//! A chunk latency per byte higher than this multiple of the lowest one is a congestion signal
+static constexpr double LATENCY_DEGRADATION = 4.0;
+//! Growth of the lowest chunk latency per byte at each download, so that it follows a lasting change of the network
+static constexpr double LATENCY_BASELINE_DECAY = 0.01;
+
+constexpr int32_t AzureAdaptiveTransfer::MIN_CONCURRENCY;
+constexpr int32_t AzureAdaptiveTransfer::MAX_CONCURRENCY;
+constexpr int64_t AzureAdaptiveTransfer::MIN_CHUNK_SIZE;
+constexpr int64_t AzureAdaptiveTransfer::MAX_CHUNK_SIZE;
+constexpr int64_t AzureAdaptiveTransfer::CHUNK_SIZE_STEP;
+
+AzureAdaptiveTransfer::AzureAdaptiveTransfer(const AzureTransferSettings &initial_settings)
+    : settings(initial_settings), average_throughput(0), min_chunk_latency(0) {
+	settings.concurrency = MaxValue<int32_t>(MinValue<int32_t>(settings.concurrency, MAX_CONCURRENCY), MIN_CONCURRENCY);
+	settings.chunk_size = MaxValue<int64_t>(MinValue<int64_t>(settings.chunk_size, MAX_CHUNK_SIZE), MIN_CHUNK_SIZE);
+}
+
+AzureTransferSettings AzureAdaptiveTransfer::GetSettings() {
+	lock_guard<mutex> guard(lock);
+	return settings;
+}
+
+AzureTransferSettings AzureAdaptiveTransfer::ForDownload(const AzureTransferSettings &settings, idx_t bytes) {
+	auto result = settings;
+	result.chunk_size = MaxValue<int64_t>(MinValue<int64_t>(settings.chunk_size, bytes / 2), MIN_CHUNK_SIZE);
+	return result;
+}
+
+void AzureAdaptiveTransfer::Record(const AzureTransferSettings &used_settings, idx_t bytes, int64_t elapsed_us,
+                                   bool failed) {
+	lock_guard<mutex> guard(lock);
+	// Concurrent downloads done with the same settings must only change them once
+	const bool current = used_settings.concurrency == settings.concurrency &&
+	                     used_settings.chunk_size == settings.chunk_size;
+	if (failed) {
+		if (current) {
+			Decrease();
+		}
+		return;
+	}
+	// The settings have no effect on a download done with a single request
+	const auto download_settings = ForDownload(used_settings, bytes);
+	if (bytes <= static_cast<idx_t>(download_settings.chunk_size) || elapsed_us <= 0) {
+		return;
+	}
+
+	const auto throughput = static_cast<double>(bytes) / static_cast<double>(elapsed_us);
+	const auto chunk_count = (bytes + download_settings.chunk_size - 1) / download_settings.chunk_size;
+	const auto round_count = (chunk_count + download_settings.concurrency - 1) / download_settings.concurrency;
+	const auto chunk_latency = static_cast<double>(elapsed_us) / static_cast<double>(round_count) /
+	                           static_cast<double>(download_settings.chunk_size);
+
+	const bool congested = (average_throughput > 0 && throughput < average_throughput * THROUGHPUT_DEGRADATION) ||
+	                       (min_chunk_latency > 0 && chunk_latency > min_chunk_latency * LATENCY_DEGRADATION);
+
+	if (average_throughput == 0) {
+		average_throughput = throughput;
+	} else {
+		average_throughput = THROUGHPUT_SMOOTHING * throughput + (1 - THROUGHPUT_SMOOTHING) * average_throughput;
+	}
+	min_chunk_latency *= 1 + LATENCY_BASELINE_DECAY;
+	if (min_chunk_latency == 0 || chunk_latency < min_chunk_latency) {
+		min_chunk_latency = chunk_latency;
+	}
+
+	if (!current) {
+		return;
+	}
+	if (congested) {
+		Decrease();
+	} else {
+		Increase();
+	}
+}
+
+void AzureAdaptiveTransfer::Increase() {
+	settings.concurrency = MinValue<int32_t>(settings.concurrency + 1, MAX_CONCURRENCY);
+	settings.chunk_size = MinValue<int64_t>(settings.chunk_size + CHUNK_SIZE_STEP, MAX_CHUNK_SIZE);
+}
+
+void AzureAdaptiveTransfer::Decrease() {
+	settings.concurrency = MaxValue<int32_t>(settings.concurrency / 2, MIN_CONCURRENCY);
+	settings.chunk_size = MaxValue<int64_t>(settings.chunk_size / 2, MIN_CHUNK_SIZE);
+}
+
+shared_ptr<AzureAdaptiveTransferRegistry> AzureAdaptiveTransferRegistry::GetRegistry(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureAdaptiveTransferRegistry>(ObjectType());
+}
+
+shared_ptr<AzureAdaptiveTransfer>
+AzureAdaptiveTransferRegistry::GetAccount(const std::string &account, const AzureTransferSettings &initial_settings) {
+	lock_guard<mutex> guard(lock);
+	auto &entry = accounts[account];
+	if (!entry) {
+		entry = make_shared_ptr<AzureAdaptiveTransfer>(initial_settings);
+	}
+	return entry;
+}
+
+string AzureAdaptiveTransferRegistry::ObjectType() {
+	return "azure_adaptive_transfer";
+}
+
+string AzureAdaptiveTransferRegistry::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -1,5 +1,6 @@
 #include "azure_blob_filesystem.hpp"
 
+#include "azure_listing_queue.hpp"
 #include "azure_storage_account_client.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
@@ -15,6 +16,9 @@
 #include "duckdb/main/extension_util.hpp"
 #include "duckdb/main/client_data.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include <algorithm>
+#include <azure/core/base64.hpp>
+#include <azure/core/io/body_stream.hpp>
 #include <azure/storage/blobs.hpp>
 #include <chrono>
 #include <cstdlib>
@@ -56,10 +60,17 @@ static bool Match(vector<string>::const_iterator key, vector<string>::const_iter
 	return key == key_end && pattern == pattern_end;
 }
 
+static bool HasWildcard(const string &segment) {
+	return segment.find_first_of("*[\\") != string::npos;
+}
+
 //////// AzureBlobContextState ////////
 AzureBlobContextState::AzureBlobContextState(Azure::Storage::Blobs::BlobServiceClient client,
-                                             const AzureReadOptions &azure_read_options)
-    : AzureContextState(azure_read_options), service_client(std::move(client)) {
+                                             const AzureReadOptions &azure_read_options,
+                                             const AzureWriteOptions &azure_write_options,
+                                             shared_ptr<AzureHTTPState> http_state)
+    : AzureContextState(azure_read_options, azure_write_options, std::move(http_state)),
+      service_client(std::move(client)) {
 }
 
 Azure::Storage::Blobs::BlobContainerClient
@@ -69,9 +80,20 @@ AzureBlobContextState::GetBlobContainerClient(const std::string &blobContainerNa
 
 //////// AzureBlobStorageFileHandle ////////
 AzureBlobStorageFileHandle::AzureBlobStorageFileHandle(AzureBlobStorageFileSystem &fs, string path, FileOpenFlags flags,
-                                                       const AzureReadOptions &read_options,
-                                                       Azure::Storage::Blobs::BlobClient blob_client)
-    : AzureFileHandle(fs, std::move(path), flags, read_options), blob_client(std::move(blob_client)) {
+                                                       shared_ptr<AzureContextState> storage_context,
+                                                       Azure::Storage::Blobs::BlockBlobClient blob_client)
+    : AzureFileHandle(fs, std::move(path), flags, std::move(storage_context)), blob_client(std::move(blob_client)) {
+}
+
+AzureBlobStorageFileHandle::~AzureBlobStorageFileHandle() {
+	// Background transfers use the blob client, make sure they are done before it is destroyed. A handle written
+	// and never closed belongs to a failed write: the staged blocks are not committed, they are garbage collected by
+	// the service
+	try {
+		Discard();
+	} catch (...) {
+		// Destructors must not throw
+	}
 }
 
 //////// AzureBlobStorageFileSystem ////////
@@ -88,8 +110,7 @@ unique_ptr<AzureFileHandle> AzureBlobStorageFileSystem::CreateHandle(const strin
 	auto container = storage_context->As<AzureBlobContextState>().GetBlobContainerClient(parsed_url.container);
 	auto blob_client = container.GetBlockBlobClient(parsed_url.path);
 
-	auto handle = make_uniq<AzureBlobStorageFileHandle>(*this, path, flags, storage_context->read_options,
-	                                                    std::move(blob_client));
+	auto handle = make_uniq<AzureBlobStorageFileHandle>(*this, path, flags, storage_context, std::move(blob_client));
 	if (!handle->PostConstruct()) {
 		return nullptr;
 	}
@@ -111,34 +132,135 @@ vector<string> AzureBlobStorageFileSystem::Glob(const string &path, FileOpener *
 	// Azure matches on prefix, not glob pattern, so we take a substring until the first wildcard
 	auto first_wildcard_pos = azure_url.path.find_first_of("*[\\");
 	if (first_wildcard_pos == string::npos) {
+		// Likely a file of a list given to a multi-file reader, fetch its info while the rest of the list is expanded
+		PrefetchFileMetadata({path}, opener);
 		return {path};
 	}
 
-	string shared_path = azure_url.path.substr(0, first_wildcard_pos);
 	auto container_client = storage_context->As<AzureBlobContextState>().GetBlobContainerClient(azure_url.container);
-
 	const auto pattern_splits = StringUtil::Split(azure_url.path, "/");
-	vector<string> result;
-
-	Azure::Storage::Blobs::ListBlobsOptions options;
-	options.Prefix = shared_path;
-
 	const auto path_result_prefix =
 	    (azure_url.is_fully_qualified ? (azure_url.prefix + azure_url.storage_account_name + '.' + azure_url.endpoint +
 	                                     '/' + azure_url.container)
 	                                  : (azure_url.prefix + azure_url.container));
+
+	mutex result_lock;
+	vector<string> result;
+	auto add_match = [&](const Azure::Storage::Blobs::Models::BlobItem &blob) {
+		auto result_full_url = path_result_prefix + '/' + blob.Name;
+		storage_context->AddFileMetadata(result_full_url, AzureFileMetadata {static_cast<idx_t>(blob.BlobSize),
+		                                                                     ToTimeT(blob.Details.LastModified),
+		                                                                     blob.Details.ETag.ToString()});
+		lock_guard<mutex> guard(result_lock);
+		result.push_back(std::move(result_full_url));
+	};
+
+	auto &http_state = storage_context->http_state;
+	const auto start_time = std::chrono::steady_clock::now();
+	auto add_list_time = [&]() {
+		if (http_state) {
+			http_state->list_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+			                                std::chrono::steady_clock::now() - start_time)
+			                                .count();
+		}
+	};
+
+	auto list_concurrency = GetListConcurrency(opener);
+	if (list_concurrency <= 1) {
+		ListBlobs(container_client, azure_url.path.substr(0, first_wildcard_pos), pattern_splits,
+		          storage_context->request_context, http_state, add_match);
+		add_list_time();
+		return result;
+	}
+
+	// Expand the pattern one directory level at a time, the sub prefixes that can match are listed concurrently
+	AzureListingQueue<BlobListingTask> queue(list_concurrency, [&](const BlobListingTask &task,
+	                                                               AzureListingQueue<BlobListingTask> &listing) {
+		auto prefix = task.prefix;
+		auto segment_idx = task.segment_idx;
+		// Directories without wildcard do not need to be listed
+		while (segment_idx + 1 < pattern_splits.size() && !HasWildcard(pattern_splits[segment_idx])) {
+			prefix += pattern_splits[segment_idx] + '/';
+			segment_idx++;
+		}
+
+		const auto &segment = pattern_splits[segment_idx];
+		if (segment == "**") {
+			// Any depth can match, list everything below the prefix
+			ListBlobs(container_client, prefix, pattern_splits, storage_context->request_context, http_state,
+			          add_match);
+			return;
+		}
+
+		const bool is_last_segment = segment_idx + 1 == pattern_splits.size();
+		Azure::Storage::Blobs::ListBlobsOptions options;
+		options.Prefix = prefix + segment.substr(0, segment.find_first_of("*[\\"));
+		while (true) {
+			Azure::Storage::Blobs::ListBlobsByHierarchyPagedResponse res;
+			try {
+				res = container_client.ListBlobsByHierarchy("/", options, storage_context->request_context);
+			} catch (Azure::Storage::StorageException &e) {
+				throw IOException("AzureStorageFileSystem Read to %s failed with %s Reason Phrase: %s", path,
+				                  e.ErrorCode, e.ReasonPhrase);
+			}
+			if (http_state) {
+				http_state->list_count++;
+			}
+
+			if (is_last_segment) {
+				for (const auto &blob : res.Blobs) {
+					auto name = blob.Name.substr(prefix.length());
+					if (duckdb::Glob(name.data(), name.length(), segment.data(), segment.length())) {
+						add_match(blob);
+					}
+				}
+			} else {
+				// Prune the sub prefixes (directories) that cannot match
+				for (const auto &blob_prefix : res.BlobPrefixes) {
+					auto name = blob_prefix.substr(prefix.length(), blob_prefix.length() - prefix.length() - 1);
+					if (duckdb::Glob(name.data(), name.length(), segment.data(), segment.length())) {
+						listing.Push(BlobListingTask {blob_prefix, segment_idx + 1});
+					}
+				}
+			}
+
+			// Manage Azure pagination
+			if (res.NextPageToken) {
+				options.ContinuationToken = res.NextPageToken;
+			} else {
+				break;
+			}
+		}
+	});
+	queue.Push(BlobListingTask {string(), 0});
+	queue.Run();
+	add_list_time();
+
+	// Same order as a flat listing
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+void AzureBlobStorageFileSystem::ListBlobs(const Azure::Storage::Blobs::BlobContainerClient &container_client,
+                                           const string &prefix, const vector<string> &pattern_splits,
+                                           const Azure::Core::Context &context,
+                                           const shared_ptr<AzureHTTPState> &http_state,
+                                           const std::function<void(const BlobItem &)> &on_match) {
+	Azure::Storage::Blobs::ListBlobsOptions options;
+	options.Prefix = prefix;
+
 	while (true) {
 		// Perform query
 		Azure::Storage::Blobs::ListBlobsPagedResponse res;
 		try {
-			res = container_client.ListBlobs(options);
+			res = container_client.ListBlobs(options, context);
 		} catch (Azure::Storage::StorageException &e) {
-			throw IOException("AzureStorageFileSystem Read to %s failed with %s Reason Phrase: %s", path, e.ErrorCode,
-			                  e.ReasonPhrase);
+			throw IOException("AzureStorageFileSystem Read to %s failed with %s Reason Phrase: %s", prefix,
+			                  e.ErrorCode, e.ReasonPhrase);
+		}
+		if (http_state) {
+			http_state->list_count++;
 		}
-
-		// Assuming that in the majority of the case it's wildcard
-		result.reserve(result.size() + res.Blobs.size());
 
 		// Ensure that the retrieved element match the expected pattern
 		for (const auto &key : res.Blobs) {
@@ -146,8 +268,7 @@ vector<string> AzureBlobStorageFileSystem::Glob(const string &path, FileOpener *
 			bool is_match = Match(key_splits.begin(), key_splits.end(), pattern_splits.begin(), pattern_splits.end());
 
 			if (is_match) {
-				auto result_full_url = path_result_prefix + '/' + key.Name;
-				result.push_back(result_full_url);
+				on_match(key);
 			}
 		}
 
@@ -158,33 +279,85 @@ vector<string> AzureBlobStorageFileSystem::Glob(const string &path, FileOpener *
 			break;
 		}
 	}
-
-	return result;
 }
 
 void AzureBlobStorageFileSystem::LoadRemoteFileInfo(AzureFileHandle &handle) {
 	auto &hfh = handle.Cast<AzureBlobStorageFileHandle>();
 
-	auto res = hfh.blob_client.GetProperties();
+	auto res = hfh.blob_client.GetProperties(Azure::Storage::Blobs::GetBlobPropertiesOptions(),
+	                                         hfh.storage_context->request_context);
 	hfh.length = res.Value.BlobSize;
 	hfh.last_modified = ToTimeT(res.Value.LastModified);
+	hfh.etag = res.Value.ETag.ToString();
 }
 
 bool AzureBlobStorageFileSystem::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
+	auto parsed_url = ParseUrl(filename);
+	auto storage_context = GetOrCreateStorageContext(opener, filename, parsed_url);
+
+	bool exists;
+	AzureFileMetadata metadata;
+	if (TryGetKnownExistence(*storage_context, filename, exists, metadata)) {
+		return exists && metadata.length > 0;
+	}
+
+	// Only the properties are needed, opening a handle could also download data
+	auto blob_client = storage_context->As<AzureBlobContextState>()
+	                       .GetBlobContainerClient(parsed_url.container)
+	                       .GetBlobClient(parsed_url.path);
 	try {
-		auto handle = OpenFile(filename, FileFlags::FILE_FLAGS_READ, opener);
-		auto &sfh = handle->Cast<AzureBlobStorageFileHandle>();
-		if (sfh.length == 0) {
+		auto res = blob_client.GetProperties(Azure::Storage::Blobs::GetBlobPropertiesOptions(),
+		                                     storage_context->request_context);
+		// Opening the file later in the query will not need another request
+		storage_context->AddFileMetadata(filename, AzureFileMetadata {static_cast<idx_t>(res.Value.BlobSize),
+		                                                              ToTimeT(res.Value.LastModified),
+		                                                              res.Value.ETag.ToString()});
+		return res.Value.BlobSize > 0;
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound) {
+			OnFileNotFound(*storage_context, filename);
 			return false;
 		}
-		return true;
-	} catch (...) {
-		return false;
-	};
+		// A missing permission or an unreachable account must not look like a missing file
+		throw IOException("AzureBlobStorageFileSystem could not check file '%s': %s Reason Phrase: %s", filename,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+bool AzureBlobStorageFileSystem::LoadRemoteFileMetadata(AzureContextState &storage_context, const string &path,
+                                                        AzureFileMetadata &metadata) {
+	auto parsed_url = ParseUrl(path);
+	auto res = storage_context.As<AzureBlobContextState>()
+	               .GetBlobContainerClient(parsed_url.container)
+	               .GetBlobClient(parsed_url.path)
+	               .GetProperties(Azure::Storage::Blobs::GetBlobPropertiesOptions(), storage_context.request_context);
+	metadata = AzureFileMetadata {static_cast<idx_t>(res.Value.BlobSize), ToTimeT(res.Value.LastModified),
+	                              res.Value.ETag.ToString()};
+	return true;
+}
+
+idx_t AzureBlobStorageFileSystem::LoadRemoteFileInfoWithRange(AzureFileHandle &handle, char *buffer_out,
+                                                              idx_t buffer_out_len) {
+	auto &hfh = handle.Cast<AzureBlobStorageFileHandle>();
+
+	// A single request, the range is truncated by the service when the file is smaller
+	Azure::Core::Http::HttpRange range;
+	range.Offset = 0;
+	range.Length = buffer_out_len;
+	Azure::Storage::Blobs::DownloadBlobToOptions options;
+	options.Range = range;
+	options.TransferOptions.InitialChunkSize = buffer_out_len;
+	auto res = hfh.blob_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options,
+	                                     hfh.storage_context->request_context);
+	hfh.length = res.Value.BlobSize;
+	hfh.last_modified = ToTimeT(res.Value.Details.LastModified);
+	hfh.etag = res.Value.Details.ETag.ToString();
+	return MinValue<idx_t>(hfh.length, buffer_out_len);
 }
 
-void AzureBlobStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
-                                           idx_t buffer_out_len) {
+void AzureBlobStorageFileSystem::DownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                               idx_t buffer_out_len, const AzureTransferSettings &transfer,
+                                               const Azure::Core::Context &context) {
 	auto &afh = handle.Cast<AzureBlobStorageFileHandle>();
 
 	try {
@@ -194,10 +367,10 @@ void AzureBlobStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_o
 		range.Length = buffer_out_len;
 		Azure::Storage::Blobs::DownloadBlobToOptions options;
 		options.Range = range;
-		options.TransferOptions.Concurrency = afh.read_options.transfer_concurrency;
-		options.TransferOptions.InitialChunkSize = afh.read_options.transfer_chunk_size;
-		options.TransferOptions.ChunkSize = afh.read_options.transfer_chunk_size;
-		auto res = afh.blob_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options);
+		options.TransferOptions.Concurrency = transfer.concurrency;
+		options.TransferOptions.InitialChunkSize = transfer.chunk_size;
+		options.TransferOptions.ChunkSize = transfer.chunk_size;
+		auto res = afh.blob_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options, context);
 
 	} catch (const Azure::Storage::StorageException &e) {
 		throw IOException("AzureBlobStorageFileSystem Read to '%s' failed with %s Reason Phrase: %s", afh.path,
@@ -205,13 +378,97 @@ void AzureBlobStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_o
 	}
 }
 
+void AzureBlobStorageFileSystem::UploadBlock(AzureFileHandle &handle, idx_t block_idx, idx_t file_offset,
+                                             const data_t *data, idx_t length) {
+	auto &afh = handle.Cast<AzureBlobStorageFileHandle>();
+	try {
+		Azure::Core::IO::MemoryBodyStream content(data, length);
+		afh.blob_client.StageBlock(BlockId(block_idx), content, Azure::Storage::Blobs::StageBlockOptions(),
+		                           afh.storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureBlobStorageFileSystem Write to '%s' failed with %s Reason Phrase: %s", afh.path,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+void AzureBlobStorageFileSystem::CommitUpload(AzureFileHandle &handle, idx_t block_count, idx_t length) {
+	auto &afh = handle.Cast<AzureBlobStorageFileHandle>();
+	std::vector<std::string> block_ids;
+	block_ids.reserve(block_count);
+	for (idx_t block_idx = 0; block_idx < block_count; block_idx++) {
+		block_ids.push_back(BlockId(block_idx));
+	}
+	try {
+		afh.blob_client.CommitBlockList(block_ids, Azure::Storage::Blobs::CommitBlockListOptions(),
+		                                afh.storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureBlobStorageFileSystem Write to '%s' failed with %s Reason Phrase: %s", afh.path,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+std::string AzureBlobStorageFileSystem::BlockId(idx_t block_idx) {
+	auto id = StringUtil::Format("duckdb-%012llu", static_cast<unsigned long long>(block_idx));
+	return Azure::Core::Convert::Base64Encode(std::vector<uint8_t>(id.begin(), id.end()));
+}
+
+void AzureBlobStorageFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	if (!opener) {
+		throw InternalException("Cannot do Azure storage RemoveFile without FileOpener");
+	}
+
+	auto parsed_url = ParseUrl(filename);
+	auto storage_context = GetOrCreateStorageContext(opener, filename, parsed_url);
+	auto blob_client = storage_context->As<AzureBlobContextState>()
+	                       .GetBlobContainerClient(parsed_url.container)
+	                       .GetBlobClient(parsed_url.path);
+	try {
+		blob_client.Delete(Azure::Storage::Blobs::DeleteBlobOptions(), storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureBlobStorageFileSystem could not remove file '%s': %s Reason Phrase: %s", filename,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+	OnFileRemoved(*storage_context, filename);
+}
+
+void AzureBlobStorageFileSystem::MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener) {
+	if (!opener) {
+		throw InternalException("Cannot do Azure storage MoveFile without FileOpener");
+	}
+
+	auto source_url = ParseUrl(source);
+	auto target_url = ParseUrl(target);
+	if (source_url.storage_account_name != target_url.storage_account_name) {
+		throw NotImplementedException("Moving a file between Azure storage accounts is not supported");
+	}
+	auto storage_context = GetOrCreateStorageContext(opener, target, target_url);
+	auto &blob_context = storage_context->As<AzureBlobContextState>();
+	auto source_client = blob_context.GetBlobContainerClient(source_url.container).GetBlobClient(source_url.path);
+	auto target_client = blob_context.GetBlobContainerClient(target_url.container).GetBlobClient(target_url.path);
+
+	// Blob storage has no rename: copy the blob server side, then remove the source
+	try {
+		auto copy = target_client.StartCopyFromUri(source_client.GetUrl(),
+		                                           Azure::Storage::Blobs::StartBlobCopyFromUriOptions(),
+		                                           storage_context->request_context);
+		copy.PollUntilDone(std::chrono::milliseconds(100), storage_context->request_context);
+		source_client.Delete(Azure::Storage::Blobs::DeleteBlobOptions(), storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureBlobStorageFileSystem could not move '%s' to '%s': %s Reason Phrase: %s", source,
+		                  target, e.ErrorCode, e.ReasonPhrase);
+	}
+	OnFileRemoved(*storage_context, source);
+	OnFileWritten(*storage_context, target);
+}
+
 shared_ptr<AzureContextState> AzureBlobStorageFileSystem::CreateStorageContext(optional_ptr<FileOpener> opener,
                                                                                const string &path,
                                                                                const AzureParsedUrl &parsed_url) {
 	auto azure_read_options = ParseAzureReadOptions(opener);
+	auto azure_write_options = ParseAzureWriteOptions(opener);
 
 	return make_shared_ptr<AzureBlobContextState>(ConnectToBlobStorageAccount(opener, path, parsed_url),
-	                                              azure_read_options);
+	                                              azure_read_options, azure_write_options, GetHttpState(opener));
 }
 
 } // namespace duckdb
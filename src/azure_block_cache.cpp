@@ -0,0 +1,142 @@
+#include "azure_block_cache.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+AzureBlockCache::AzureBlockCache(BufferManager &buffer_manager)
+    : buffer_manager(buffer_manager), capacity(0), size(0) {
+}
+
+shared_ptr<AzureBlockCache> AzureBlockCache::GetCache(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureBlockCache>(ObjectType(),
+	                                                                         BufferManager::GetBufferManager(context));
+}
+
+std::string AzureBlockCache::BlockKey(const std::string &path, const std::string &etag, idx_t block_size,
+                                      idx_t block_idx) {
+	return path + '\n' + etag + '\n' + std::to_string(block_size) + '\n' + std::to_string(block_idx);
+}
+
+shared_ptr<AzureCachedBlock> AzureBlockCache::Get(const std::string &key) {
+	shared_ptr<BlockHandle> block_handle;
+	idx_t length;
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = blocks.find(key);
+		if (entry == blocks.end()) {
+			miss_count++;
+			return nullptr;
+		}
+		block_handle = entry->second.block;
+		length = entry->second.length;
+	}
+
+	auto block = make_shared_ptr<AzureCachedBlock>();
+	block->buffer = buffer_manager.Pin(block_handle);
+	block->length = length;
+
+	lock_guard<mutex> guard(lock);
+	auto entry = blocks.find(key);
+	if (!block->buffer.IsValid()) {
+		// Destroyed by the buffer manager to make room for something else
+		if (entry != blocks.end() && entry->second.block == block_handle) {
+			Remove(entry);
+		}
+		miss_count++;
+		return nullptr;
+	}
+	if (entry != blocks.end()) {
+		// Move the block at the head of the LRU list
+		lru.splice(lru.begin(), lru, entry->second.lru_position);
+	}
+	hit_count++;
+	return block;
+}
+
+bool AzureBlockCache::Contains(const std::string &key) {
+	lock_guard<mutex> guard(lock);
+	return blocks.find(key) != blocks.end();
+}
+
+void AzureBlockCache::Insert(const std::string &key, const data_t *data, idx_t length) {
+	{
+		lock_guard<mutex> guard(lock);
+		if (length > capacity || blocks.find(key) != blocks.end()) {
+			return;
+		}
+		EvictUntil(capacity - length);
+	}
+
+	shared_ptr<BlockHandle> block_handle;
+	try {
+		// The block can be destroyed (instead of being spilled to disk) once unpinned, it can be downloaded again
+		auto buffer = buffer_manager.Allocate(MemoryTag::EXTENSION, length, true);
+		memcpy(buffer.Ptr(), data, length);
+		block_handle = buffer.GetBlockHandle();
+	} catch (const OutOfMemoryException &) {
+		// The cache is only an optimization, it should never make a query fail
+		return;
+	}
+
+	lock_guard<mutex> guard(lock);
+	if (blocks.find(key) != blocks.end()) {
+		// Inserted concurrently
+		return;
+	}
+	EvictUntil(capacity > length ? capacity - length : 0);
+	lru.push_front(key);
+	blocks[key] = CacheEntry {std::move(block_handle), length, lru.begin()};
+	size += length;
+}
+
+void AzureBlockCache::EvictUntil(idx_t target_size) {
+	while (size > target_size && !lru.empty()) {
+		auto entry = blocks.find(lru.back());
+		D_ASSERT(entry != blocks.end());
+		Remove(entry);
+	}
+}
+
+void AzureBlockCache::Remove(unordered_map<std::string, CacheEntry>::iterator entry) {
+	size -= entry->second.length;
+	lru.erase(entry->second.lru_position);
+	blocks.erase(entry);
+}
+
+void AzureBlockCache::SetCapacity(idx_t new_capacity) {
+	lock_guard<mutex> guard(lock);
+	capacity = new_capacity;
+	EvictUntil(capacity);
+}
+
+void AzureBlockCache::Clear() {
+	lock_guard<mutex> guard(lock);
+	EvictUntil(0);
+}
+
+idx_t AzureBlockCache::GetCapacity() {
+	lock_guard<mutex> guard(lock);
+	return capacity;
+}
+
+idx_t AzureBlockCache::GetSize() {
+	lock_guard<mutex> guard(lock);
+	return size;
+}
+
+idx_t AzureBlockCache::GetBlockCount() {
+	lock_guard<mutex> guard(lock);
+	return blocks.size();
+}
+
+string AzureBlockCache::ObjectType() {
+	return "azure_block_cache";
+}
+
+string AzureBlockCache::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -0,0 +1,139 @@
+#include "azure_cache_functions.hpp"
+#include "azure_block_cache.hpp"
+#include "azure_client_pool.hpp"
+#include "azure_disk_cache.hpp"
+#include "azure_not_found_cache.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+struct AzureCacheFunctionState : public GlobalTableFunctionState {
+	bool finished = false;
+};
+
+static unique_ptr<GlobalTableFunctionState> AzureCacheFunctionInit(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+	return make_uniq<AzureCacheFunctionState>();
+}
+
+//! The disk cache is configured by the first query reading a file, configure it here too so that the blocks
+//! written by a previous process are visible before that
+static shared_ptr<AzureDiskCache> GetDiskCache(ClientContext &context) {
+	auto disk_cache = AzureDiskCache::GetCache(context);
+
+	Value directory_val;
+	if (!context.TryGetCurrentSetting("azure_disk_cache_directory", directory_val) || directory_val.IsNull() ||
+	    directory_val.ToString().empty() || !disk_cache->GetDirectory().empty()) {
+		return disk_cache;
+	}
+	Value max_size_val;
+	Value eviction_val;
+	context.TryGetCurrentSetting("azure_disk_cache_max_size", max_size_val);
+	context.TryGetCurrentSetting("azure_disk_cache_eviction", eviction_val);
+	disk_cache->Configure(directory_val.ToString(), max_size_val.GetValue<idx_t>(),
+	                      AzureDiskCache::ParseEviction(eviction_val.ToString()));
+	return disk_cache;
+}
+
+//////// azure_cache_stats ////////
+static unique_ptr<FunctionData> AzureCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("cache");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("entries");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("size");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("capacity");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("misses");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return nullptr;
+}
+
+static void AzureCacheStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<AzureCacheFunctionState>();
+	if (state.finished) {
+		return;
+	}
+	state.finished = true;
+
+	auto block_cache = AzureBlockCache::GetCache(context);
+	output.SetValue(0, 0, Value("memory"));
+	output.SetValue(1, 0, Value::UBIGINT(block_cache->GetBlockCount()));
+	output.SetValue(2, 0, Value::UBIGINT(block_cache->GetSize()));
+	output.SetValue(3, 0, Value::UBIGINT(block_cache->GetCapacity()));
+	output.SetValue(4, 0, Value::UBIGINT(block_cache->hit_count));
+	output.SetValue(5, 0, Value::UBIGINT(block_cache->miss_count));
+
+	auto disk_cache = GetDiskCache(context);
+	// The blocks read by the previous queries may still be queued, so wait for them to be accounted
+	disk_cache->Flush();
+	output.SetValue(0, 1, Value("disk"));
+	output.SetValue(1, 1, Value::UBIGINT(disk_cache->GetBlockCount()));
+	output.SetValue(2, 1, Value::UBIGINT(disk_cache->GetSize()));
+	output.SetValue(3, 1, Value::UBIGINT(disk_cache->GetCapacity()));
+	output.SetValue(4, 1, Value::UBIGINT(disk_cache->hit_count));
+	output.SetValue(5, 1, Value::UBIGINT(disk_cache->miss_count));
+
+	// Paths recently found missing, they hold no data
+	auto not_found_cache = AzureNotFoundCache::GetCache(context);
+	output.SetValue(0, 2, Value("not_found"));
+	output.SetValue(1, 2, Value::UBIGINT(not_found_cache->GetEntryCount()));
+	output.SetValue(2, 2, Value::UBIGINT(0));
+	output.SetValue(3, 2, Value::UBIGINT(AzureNotFoundCache::MAX_ENTRIES));
+	output.SetValue(4, 2, Value::UBIGINT(not_found_cache->hit_count));
+	output.SetValue(5, 2, Value::UBIGINT(not_found_cache->miss_count));
+
+	// Storage account clients shared between queries, they hold no data. The blob and DFS clients are bounded
+	// separately
+	auto client_pool = ObjectCache::GetObjectCache(context).GetOrCreate<AzureClientPool>(AzureClientPool::ObjectType());
+	output.SetValue(0, 3, Value("clients"));
+	output.SetValue(1, 3, Value::UBIGINT(client_pool->GetClientCount()));
+	output.SetValue(2, 3, Value::UBIGINT(0));
+	output.SetValue(3, 3, Value::UBIGINT(2 * AzureClientPool::MAX_POOLED_CLIENTS));
+	output.SetValue(4, 3, Value::UBIGINT(client_pool->hit_count));
+	output.SetValue(5, 3, Value::UBIGINT(client_pool->miss_count));
+
+	output.SetCardinality(4);
+}
+
+//////// azure_cache_clear ////////
+static unique_ptr<FunctionData> AzureCacheClearBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("success");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	return nullptr;
+}
+
+static void AzureCacheClearFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<AzureCacheFunctionState>();
+	if (state.finished) {
+		return;
+	}
+	state.finished = true;
+
+	AzureBlockCache::GetCache(context)->Clear();
+	GetDiskCache(context)->Clear();
+	AzureNotFoundCache::GetCache(context)->Clear();
+
+	output.SetValue(0, 0, Value::BOOLEAN(true));
+	output.SetCardinality(1);
+}
+
+void AzureCacheFunctions::Register(DatabaseInstance &instance) {
+	TableFunction stats_function("azure_cache_stats", {}, AzureCacheStatsFunction, AzureCacheStatsBind,
+	                             AzureCacheFunctionInit);
+	ExtensionUtil::RegisterFunction(instance, stats_function);
+
+	TableFunction clear_function("azure_cache_clear", {}, AzureCacheClearFunction, AzureCacheClearBind,
+	                             AzureCacheFunctionInit);
+	ExtensionUtil::RegisterFunction(instance, clear_function);
+}
+
+} // namespace duckdb
@@ -0,0 +1,87 @@
+#include "azure_client_pool.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+constexpr idx_t AzureClientPool::MAX_POOLED_CLIENTS;
+
+shared_ptr<AzureClientPool> AzureClientPool::TryGetPool(optional_ptr<FileOpener> opener) {
+	Value value;
+	bool azure_client_pooling = true;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_client_pooling", value)) {
+		azure_client_pooling = value.GetValue<bool>();
+	}
+
+	auto client_context = FileOpener::TryGetClientContext(opener);
+	if (!azure_client_pooling || !client_context) {
+		return nullptr;
+	}
+	return ObjectCache::GetObjectCache(*client_context).GetOrCreate<AzureClientPool>(ObjectType());
+}
+
+template <class CLIENT>
+CLIENT AzureClientPool::GetOrCreate(PooledClients<CLIENT> &clients, const std::string &key,
+                                    const std::function<CLIENT()> &create) {
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = clients.entries.find(key);
+		if (entry != clients.entries.end()) {
+			clients.lru.splice(clients.lru.begin(), clients.lru, entry->second.lru_position);
+			hit_count++;
+			return *entry->second.client;
+		}
+	}
+	miss_count++;
+
+	// Build the client outside of the lock, with some credentials it can take a while. If two threads race to
+	// create the same client both are valid, the last one simply replaces the first one in the pool.
+	auto client = make_shared_ptr<CLIENT>(create());
+
+	lock_guard<mutex> guard(lock);
+	auto entry = clients.entries.find(key);
+	if (entry != clients.entries.end()) {
+		entry->second.client = client;
+		clients.lru.splice(clients.lru.begin(), clients.lru, entry->second.lru_position);
+		return *client;
+	}
+	if (clients.entries.size() >= MAX_POOLED_CLIENTS) {
+		clients.entries.erase(clients.lru.back());
+		clients.lru.pop_back();
+	}
+	clients.lru.push_front(key);
+	clients.entries[key] = typename PooledClients<CLIENT>::Entry {client, clients.lru.begin()};
+	return *client;
+}
+
+Azure::Storage::Blobs::BlobServiceClient
+AzureClientPool::GetOrCreateBlobClient(const std::string &key,
+                                       const std::function<Azure::Storage::Blobs::BlobServiceClient()> &create) {
+	return GetOrCreate(blob_clients, key, create);
+}
+
+Azure::Storage::Files::DataLake::DataLakeServiceClient AzureClientPool::GetOrCreateDfsClient(
+    const std::string &key, const std::function<Azure::Storage::Files::DataLake::DataLakeServiceClient()> &create) {
+	return GetOrCreate(dfs_clients, key, create);
+}
+
+void AzureClientPool::Clear() {
+	lock_guard<mutex> guard(lock);
+	blob_clients = PooledClients<Azure::Storage::Blobs::BlobServiceClient>();
+	dfs_clients = PooledClients<Azure::Storage::Files::DataLake::DataLakeServiceClient>();
+}
+
+idx_t AzureClientPool::GetClientCount() {
+	lock_guard<mutex> guard(lock);
+	return blob_clients.entries.size() + dfs_clients.entries.size();
+}
+
+string AzureClientPool::ObjectType() {
+	return "azure_client_pool";
+}
+
+string AzureClientPool::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -1,10 +1,13 @@
 #include "azure_dfs_filesystem.hpp"
+#include "azure_listing_queue.hpp"
 #include "azure_storage_account_client.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/types/uuid.hpp"
 #include "duckdb/function/scalar/string_common.hpp"
 #include <algorithm>
+#include <azure/core/io/body_stream.hpp>
 #include <azure/storage/blobs/blob_options.hpp>
 #include <azure/storage/common/storage_exception.hpp>
 #include <azure/storage/files/datalake/datalake_file_system_client.hpp>
@@ -12,7 +15,9 @@
 #include <azure/storage/files/datalake/datalake_file_client.hpp>
 #include <azure/storage/files/datalake/datalake_options.hpp>
 #include <azure/storage/files/datalake/datalake_responses.hpp>
+#include <chrono>
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,58 +32,101 @@ inline static bool IsDfsScheme(const string &fpath) {
 	return fpath.rfind(AzureDfsStorageFileSystem::PATH_PREFIX, 0) == 0 || fpath.rfind(AzureDfsStorageFileSystem::UNSECURE_PATH_PREFIX, 0) == 0;
 }
 
+namespace {
+//! A directory to list, `end_match` is the end of the pattern part that its entries must match
+struct DfsWalkTask {
+	std::string path;
+	std::size_t end_match;
+};
+} // namespace
+
+//! Order the paths as a depth first traversal would: a directory content comes right after the directory
+static bool DfsPathLess(const Azure::Storage::Files::DataLake::Models::PathItem &a,
+                        const Azure::Storage::Files::DataLake::Models::PathItem &b) {
+	return std::lexicographical_compare(a.Name.begin(), a.Name.end(), b.Name.begin(), b.Name.end(),
+	                                    [](char lhs, char rhs) {
+		                                    // '/' sort before any other character
+		                                    auto lhs_value = lhs == '/' ? 0 : static_cast<unsigned char>(lhs);
+		                                    auto rhs_value = rhs == '/' ? 0 : static_cast<unsigned char>(rhs);
+		                                    return lhs_value < rhs_value;
+	                                    });
+}
+
 static void Walk(const Azure::Storage::Files::DataLake::DataLakeFileSystemClient &fs, const std::string &path,
-                 const string &path_pattern, std::size_t end_match, std::vector<std::string> *out_result) {
-	auto directory_client = fs.GetDirectoryClient(path);
-
-	bool recursive = false;
-	const auto double_star = path_pattern.rfind("**", end_match);
-	if (double_star != std::string::npos) {
-		if (path_pattern.length() > end_match) {
-			throw NotImplementedException("abfss do not manage recursive lookup patterns, %s is therefor illegal, only "
-			                              "pattern ending by ** are allowed.",
-			                              path_pattern);
+                 const string &path_pattern, std::size_t end_match, const Azure::Core::Context &context,
+                 idx_t concurrency, const shared_ptr<AzureHTTPState> &http_state,
+                 std::vector<Azure::Storage::Files::DataLake::Models::PathItem> *out_result) {
+	mutex result_lock;
+
+	// The directories are listed by a bounded number of workers, each listed directory schedules its sub directories
+	AzureListingQueue<DfsWalkTask> queue(concurrency, [&](const DfsWalkTask &task,
+	                                                      AzureListingQueue<DfsWalkTask> &listing) {
+		auto directory_client = fs.GetDirectoryClient(task.path);
+
+		bool recursive = false;
+		const auto double_star = path_pattern.rfind("**", task.end_match);
+		if (double_star != std::string::npos) {
+			if (path_pattern.length() > task.end_match) {
+				throw NotImplementedException("abfss do not manage recursive lookup patterns, %s is therefor illegal, "
+				                              "only pattern ending by ** are allowed.",
+				                              path_pattern);
+			}
+			// pattern end with a **, perform recursive listing from this point
+			recursive = true;
 		}
-		// pattern end with a **, perform recursive listing from this point
-		recursive = true;
-	}
 
-	Azure::Storage::Files::DataLake::ListPathsOptions options;
-	while (true) {
-		auto res = directory_client.ListPaths(recursive, options);
-
-		for (const auto &elt : res.Paths) {
-			if (elt.IsDirectory) {
-				if (!recursive) { // Only perform recursive call if we are not already processing recursive result
-					if (Glob(elt.Name.data(), elt.Name.length(), path_pattern.data(), end_match)) {
-						if (end_match >= path_pattern.length()) {
-							// Skip, no way there will be matches anymore
-							continue;
+		Azure::Storage::Files::DataLake::ListPathsOptions options;
+		std::vector<Azure::Storage::Files::DataLake::Models::PathItem> matches;
+		while (true) {
+			auto res = directory_client.ListPaths(recursive, options, context);
+			if (http_state) {
+				http_state->list_count++;
+			}
+
+			for (auto &elt : res.Paths) {
+				if (elt.IsDirectory) {
+					if (!recursive) { // Only schedule a listing if we are not already processing recursive result
+						if (Glob(elt.Name.data(), elt.Name.length(), path_pattern.data(), task.end_match)) {
+							if (task.end_match >= path_pattern.length()) {
+								// Skip, no way there will be matches anymore
+								continue;
+							}
+							listing.Push(DfsWalkTask {
+							    elt.Name, std::min(path_pattern.length(), path_pattern.find('/', task.end_match + 1))});
 						}
-						Walk(fs, elt.Name, path_pattern,
-						     std::min(path_pattern.length(), path_pattern.find('/', end_match + 1)), out_result);
+					}
+				} else {
+					// File
+					if (Glob(elt.Name.data(), elt.Name.length(), path_pattern.data(), path_pattern.length())) {
+						matches.push_back(std::move(elt));
 					}
 				}
+			}
+
+			if (res.NextPageToken) {
+				options.ContinuationToken = res.NextPageToken;
 			} else {
-				// File
-				if (Glob(elt.Name.data(), elt.Name.length(), path_pattern.data(), path_pattern.length())) {
-					out_result->push_back(elt.Name);
-				}
+				break;
 			}
 		}
 
-		if (res.NextPageToken) {
-			options.ContinuationToken = res.NextPageToken;
-		} else {
-			break;
-		}
-	}
+		lock_guard<mutex> guard(result_lock);
+		std::move(matches.begin(), matches.end(), std::back_inserter(*out_result));
+	});
+	queue.Push(DfsWalkTask {path, end_match});
+	queue.Run();
+
+	// The directories are listed in any order, sort to always return the same result
+	std::sort(out_result->begin(), out_result->end(), DfsPathLess);
 }
 
 //////// AzureDfsContextState ////////
 AzureDfsContextState::AzureDfsContextState(Azure::Storage::Files::DataLake::DataLakeServiceClient client,
-                                           const AzureReadOptions &azure_read_options)
-    : AzureContextState(azure_read_options), service_client(std::move(client)) {
+                                           const AzureReadOptions &azure_read_options,
+                                           const AzureWriteOptions &azure_write_options,
+                                           shared_ptr<AzureHTTPState> http_state)
+    : AzureContextState(azure_read_options, azure_write_options, std::move(http_state)),
+      service_client(std::move(client)) {
 }
 
 Azure::Storage::Files::DataLake::DataLakeFileSystemClient
@@ -88,9 +136,19 @@ AzureDfsContextState::GetDfsFileSystemClient(const std::string &file_system_name
 
 //////// AzureDfsContextState ////////
 AzureDfsStorageFileHandle::AzureDfsStorageFileHandle(AzureDfsStorageFileSystem &fs, string path, FileOpenFlags flags,
-                                                     const AzureReadOptions &read_options,
+                                                     shared_ptr<AzureContextState> storage_context,
                                                      Azure::Storage::Files::DataLake::DataLakeFileClient client)
-    : AzureFileHandle(fs, std::move(path), flags, read_options), file_client(std::move(client)) {
+    : AzureFileHandle(fs, std::move(path), flags, std::move(storage_context)), file_client(std::move(client)) {
+}
+
+AzureDfsStorageFileHandle::~AzureDfsStorageFileHandle() {
+	// Background transfers use the file client, make sure they are done before it is destroyed. A handle written
+	// and never closed belongs to a failed write: nothing is flushed and its temporary file is removed
+	try {
+		Discard();
+	} catch (...) {
+		// Destructors must not throw
+	}
 }
 
 //////// AzureDfsStorageFileSystem ////////
@@ -106,7 +164,7 @@ unique_ptr<AzureFileHandle> AzureDfsStorageFileSystem::CreateHandle(const string
 	auto storage_context = GetOrCreateStorageContext(opener, path, parsed_url);
 	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
 
-	auto handle = make_uniq<AzureDfsStorageFileHandle>(*this, path, flags, storage_context->read_options,
+	auto handle = make_uniq<AzureDfsStorageFileHandle>(*this, path, flags, storage_context,
 	                                                   file_system_client.GetFileClient(parsed_url.path));
 	if (!handle->PostConstruct()) {
 		return nullptr;
@@ -128,12 +186,15 @@ vector<string> AzureDfsStorageFileSystem::Glob(const string &path, FileOpener *o
 	// If path does not contains any wildcard, we assume that an absolute path therefor nothing to do
 	auto first_wildcard_pos = azure_url.path.find_first_of("*[\\");
 	if (first_wildcard_pos == string::npos) {
+		// Likely a file of a list given to a multi-file reader, fetch its info while the rest of the list is expanded
+		PrefetchFileMetadata({path}, opener);
 		return {path};
 	}
 
 	// The path contains wildcard try to list file with the minimum calls
-	auto dfs_storage_service = ConnectToDfsStorageAccount(opener, path, azure_url);
-	auto dfs_filesystem_client = dfs_storage_service.GetFileSystemClient(azure_url.container);
+	auto storage_context = GetOrCreateStorageContext(opener, path, azure_url);
+	auto dfs_filesystem_client =
+	    storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(azure_url.container);
 
 	auto index_root_dir = azure_url.path.rfind('/', first_wildcard_pos);
 	if (index_root_dir == string::npos) {
@@ -141,21 +202,35 @@ vector<string> AzureDfsStorageFileSystem::Glob(const string &path, FileOpener *o
 	}
 	auto shared_path = azure_url.path.substr(0, index_root_dir);
 
-	std::vector<std::string> result;
+	auto &http_state = storage_context->http_state;
+	const auto start_time = std::chrono::steady_clock::now();
+	std::vector<Azure::Storage::Files::DataLake::Models::PathItem> paths;
 	Walk(dfs_filesystem_client, shared_path,
 	     // pattern to match
 	     azure_url.path, std::min(azure_url.path.length(), azure_url.path.find('/', index_root_dir + 1)),
+	     storage_context->request_context, GetListConcurrency(opener), http_state,
 	     // output result
-	     &result);
+	     &paths);
+	if (http_state) {
+		http_state->list_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+		                                std::chrono::steady_clock::now() - start_time)
+		                                .count();
+	}
 
-	if (!result.empty()) {
+	vector<string> result;
+	if (!paths.empty()) {
 		const auto path_result_prefix =
 		    (azure_url.is_fully_qualified ? (azure_url.prefix + azure_url.storage_account_name + '.' +
 		                                     azure_url.endpoint + '/' + azure_url.container)
 		                                  : (azure_url.prefix + azure_url.container)) +
 		    '/';
-		for (auto &elt : result) {
-			elt = path_result_prefix + elt;
+		result.reserve(paths.size());
+		for (auto &elt : paths) {
+			auto result_full_url = path_result_prefix + elt.Name;
+			storage_context->AddFileMetadata(result_full_url,
+			                                 AzureFileMetadata {static_cast<idx_t>(elt.FileSize),
+			                                                    ToTimeT(elt.LastModified), std::move(elt.ETag)});
+			result.push_back(std::move(result_full_url));
 		}
 	}
 
@@ -165,13 +240,35 @@ vector<string> AzureDfsStorageFileSystem::Glob(const string &path, FileOpener *o
 void AzureDfsStorageFileSystem::LoadRemoteFileInfo(AzureFileHandle &handle) {
 	auto &hfh = handle.Cast<AzureDfsStorageFileHandle>();
 
-	auto res = hfh.file_client.GetProperties();
+	auto res = hfh.file_client.GetProperties(Azure::Storage::Files::DataLake::GetPathPropertiesOptions(),
+	                                         hfh.storage_context->request_context);
 	hfh.length = res.Value.FileSize;
 	hfh.last_modified = ToTimeT(res.Value.LastModified);
+	hfh.etag = res.Value.ETag.ToString();
 }
 
-void AzureDfsStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
-                                          idx_t buffer_out_len) {
+idx_t AzureDfsStorageFileSystem::LoadRemoteFileInfoWithRange(AzureFileHandle &handle, char *buffer_out,
+                                                             idx_t buffer_out_len) {
+	auto &hfh = handle.Cast<AzureDfsStorageFileHandle>();
+
+	// A single request, the range is truncated by the service when the file is smaller
+	Azure::Core::Http::HttpRange range;
+	range.Offset = 0;
+	range.Length = buffer_out_len;
+	Azure::Storage::Files::DataLake::DownloadFileToOptions options;
+	options.Range = range;
+	options.TransferOptions.InitialChunkSize = buffer_out_len;
+	auto res = hfh.file_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options,
+	                                     hfh.storage_context->request_context);
+	hfh.length = res.Value.FileSize;
+	hfh.last_modified = ToTimeT(res.Value.Details.LastModified);
+	hfh.etag = res.Value.Details.ETag.ToString();
+	return MinValue<idx_t>(hfh.length, buffer_out_len);
+}
+
+void AzureDfsStorageFileSystem::DownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                              idx_t buffer_out_len, const AzureTransferSettings &transfer,
+                                              const Azure::Core::Context &context) {
 	auto &afh = handle.Cast<AzureDfsStorageFileHandle>();
 	try {
 		// Specify the range
@@ -180,10 +277,10 @@ void AzureDfsStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_of
 		range.Length = buffer_out_len;
 		Azure::Storage::Files::DataLake::DownloadFileToOptions options;
 		options.Range = range;
-		options.TransferOptions.Concurrency = afh.read_options.transfer_concurrency;
-		options.TransferOptions.InitialChunkSize = afh.read_options.transfer_chunk_size;
-		options.TransferOptions.ChunkSize = afh.read_options.transfer_chunk_size;
-		auto res = afh.file_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options);
+		options.TransferOptions.Concurrency = transfer.concurrency;
+		options.TransferOptions.InitialChunkSize = transfer.chunk_size;
+		options.TransferOptions.ChunkSize = transfer.chunk_size;
+		auto res = afh.file_client.DownloadTo((uint8_t *)buffer_out, buffer_out_len, options, context);
 
 	} catch (const Azure::Storage::StorageException &e) {
 		throw IOException("AzureBlobStorageFileSystem Read to '%s' failed with %s Reason Phrase: %s", afh.path,
@@ -191,13 +288,259 @@ void AzureDfsStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_of
 	}
 }
 
+//! Path of a file or directory inside its file system, without the trailing '/'
+static string DfsPath(const AzureParsedUrl &parsed_url) {
+	auto path = parsed_url.path;
+	while (!path.empty() && path.back() == '/') {
+		path.pop_back();
+	}
+	return path;
+}
+
+void AzureDfsStorageFileSystem::UploadBlock(AzureFileHandle &handle, idx_t block_idx, idx_t file_offset,
+                                            const data_t *data, idx_t length) {
+	auto &afh = handle.Cast<AzureDfsStorageFileHandle>();
+	auto &upload_client = GetUploadClient(afh);
+	try {
+		// Appends at distinct offsets can be in flight concurrently, the data is only visible once flushed
+		Azure::Core::IO::MemoryBodyStream content(data, length);
+		upload_client.Append(content, static_cast<int64_t>(file_offset),
+		                       Azure::Storage::Files::DataLake::AppendFileOptions(),
+		                       afh.storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem Write to '%s' failed with %s Reason Phrase: %s", afh.path,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+void AzureDfsStorageFileSystem::CommitUpload(AzureFileHandle &handle, idx_t block_count, idx_t length) {
+	auto &afh = handle.Cast<AzureDfsStorageFileHandle>();
+	// An empty file has no append, its temporary file is created here
+	auto &upload_client = GetUploadClient(afh);
+	try {
+		upload_client.Flush(static_cast<int64_t>(length), Azure::Storage::Files::DataLake::FlushFileOptions(),
+		                    afh.storage_context->request_context);
+		if (!afh.upload_path.empty()) {
+			// The first commit atomically replaces the target, the next appends and flushes go to it directly
+			auto parsed_url = ParseUrl(afh.path);
+			afh.storage_context->As<AzureDfsContextState>()
+			    .GetDfsFileSystemClient(parsed_url.container)
+			    .RenameFile(afh.upload_path, DfsPath(parsed_url), Azure::Storage::Files::DataLake::RenameFileOptions(),
+			                afh.storage_context->request_context);
+			lock_guard<mutex> guard(afh.upload_lock);
+			afh.upload_client = make_uniq<Azure::Storage::Files::DataLake::DataLakeFileClient>(afh.file_client);
+			afh.upload_path.clear();
+		}
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem Write to '%s' failed with %s Reason Phrase: %s", afh.path,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+void AzureDfsStorageFileSystem::CleanupAbortedUpload(AzureFileHandle &handle) {
+	auto &afh = handle.Cast<AzureDfsStorageFileHandle>();
+	if (afh.upload_path.empty()) {
+		return;
+	}
+	try {
+		auto parsed_url = ParseUrl(afh.path);
+		afh.storage_context->As<AzureDfsContextState>()
+		    .GetDfsFileSystemClient(parsed_url.container)
+		    .GetFileClient(afh.upload_path)
+		    .Delete(Azure::Storage::Files::DataLake::DeleteFileOptions(), afh.storage_context->request_context);
+	} catch (...) {
+		// Best effort, the target is untouched anyway
+	}
+	afh.upload_path.clear();
+}
+
+Azure::Storage::Files::DataLake::DataLakeFileClient &
+AzureDfsStorageFileSystem::GetUploadClient(AzureDfsStorageFileHandle &handle) {
+	lock_guard<mutex> guard(handle.upload_lock);
+	if (handle.upload_client) {
+		return *handle.upload_client;
+	}
+	auto parsed_url = ParseUrl(handle.path);
+	auto upload_path = DfsPath(parsed_url) + ".duckdb_upload_" + UUID::ToString(UUID::GenerateRandomUUID());
+	auto upload_client = handle.storage_context->As<AzureDfsContextState>()
+	                         .GetDfsFileSystemClient(parsed_url.container)
+	                         .GetFileClient(upload_path);
+	try {
+		upload_client.Create(Azure::Storage::Files::DataLake::CreateFileOptions(),
+		                     handle.storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem could not create file '%s': %s Reason Phrase: %s", handle.path,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+	handle.upload_path = std::move(upload_path);
+	handle.upload_client = make_uniq<Azure::Storage::Files::DataLake::DataLakeFileClient>(std::move(upload_client));
+	return *handle.upload_client;
+}
+
+bool AzureDfsStorageFileSystem::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
+	auto parsed_url = ParseUrl(filename);
+	auto storage_context = GetOrCreateStorageContext(opener, filename, parsed_url);
+	bool exists;
+	AzureFileMetadata metadata;
+	if (TryGetKnownExistence(*storage_context, filename, exists, metadata)) {
+		return exists;
+	}
+
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
+	try {
+		auto res = file_system_client.GetFileClient(DfsPath(parsed_url))
+		               .GetProperties(Azure::Storage::Files::DataLake::GetPathPropertiesOptions(),
+		                              storage_context->request_context);
+		if (res.Value.IsDirectory) {
+			return false;
+		}
+		// Opening the file later in the query will not need another request
+		storage_context->AddFileMetadata(filename, AzureFileMetadata {static_cast<idx_t>(res.Value.FileSize),
+		                                                              ToTimeT(res.Value.LastModified),
+		                                                              res.Value.ETag.ToString()});
+		return true;
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound) {
+			OnFileNotFound(*storage_context, filename);
+			return false;
+		}
+		throw IOException("AzureDfsStorageFileSystem could not check file '%s': %s Reason Phrase: %s", filename,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+bool AzureDfsStorageFileSystem::LoadRemoteFileMetadata(AzureContextState &storage_context, const string &path,
+                                                       AzureFileMetadata &metadata) {
+	auto parsed_url = ParseUrl(path);
+	auto res = storage_context.As<AzureDfsContextState>()
+	               .GetDfsFileSystemClient(parsed_url.container)
+	               .GetFileClient(DfsPath(parsed_url))
+	               .GetProperties(Azure::Storage::Files::DataLake::GetPathPropertiesOptions(),
+	                              storage_context.request_context);
+	if (res.Value.IsDirectory) {
+		return false;
+	}
+	metadata = AzureFileMetadata {static_cast<idx_t>(res.Value.FileSize), ToTimeT(res.Value.LastModified),
+	                              res.Value.ETag.ToString()};
+	return true;
+}
+
+bool AzureDfsStorageFileSystem::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
+	auto parsed_url = ParseUrl(directory);
+	auto path = DfsPath(parsed_url);
+	if (path.empty()) {
+		// Root of the file system
+		return true;
+	}
+	auto storage_context = GetOrCreateStorageContext(opener, directory, parsed_url);
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
+	try {
+		auto res = file_system_client.GetDirectoryClient(path).GetProperties(
+		    Azure::Storage::Files::DataLake::GetPathPropertiesOptions(), storage_context->request_context);
+		return res.Value.IsDirectory;
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound) {
+			return false;
+		}
+		throw IOException("AzureDfsStorageFileSystem could not check directory '%s': %s Reason Phrase: %s",
+		                  directory, e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+void AzureDfsStorageFileSystem::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+	auto parsed_url = ParseUrl(directory);
+	auto storage_context = GetOrCreateStorageContext(opener, directory, parsed_url);
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
+	try {
+		file_system_client.GetDirectoryClient(DfsPath(parsed_url))
+		    .CreateIfNotExists(Azure::Storage::Files::DataLake::CreatePathOptions(), storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem could not create directory '%s': %s Reason Phrase: %s",
+		                  directory, e.ErrorCode, e.ReasonPhrase);
+	}
+}
+
+void AzureDfsStorageFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	auto parsed_url = ParseUrl(filename);
+	auto storage_context = GetOrCreateStorageContext(opener, filename, parsed_url);
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
+	try {
+		file_system_client.GetFileClient(DfsPath(parsed_url))
+		    .Delete(Azure::Storage::Files::DataLake::DeleteFileOptions(), storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem could not remove file '%s': %s Reason Phrase: %s", filename,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+	OnFileRemoved(*storage_context, filename);
+}
+
+void AzureDfsStorageFileSystem::MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener) {
+	auto source_url = ParseUrl(source);
+	auto target_url = ParseUrl(target);
+	if (source_url.storage_account_name != target_url.storage_account_name) {
+		throw NotImplementedException("Moving a file between Azure storage accounts is not supported");
+	}
+	auto storage_context = GetOrCreateStorageContext(opener, source, source_url);
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(source_url.container);
+
+	// Atomic rename, an existing target is replaced
+	Azure::Storage::Files::DataLake::RenameFileOptions options;
+	if (source_url.container != target_url.container) {
+		options.DestinationFileSystem = target_url.container;
+	}
+	try {
+		file_system_client.RenameFile(DfsPath(source_url), DfsPath(target_url), options,
+		                              storage_context->request_context);
+	} catch (const Azure::Storage::StorageException &e) {
+		throw IOException("AzureDfsStorageFileSystem could not move '%s' to '%s': %s Reason Phrase: %s", source,
+		                  target, e.ErrorCode, e.ReasonPhrase);
+	}
+	OnFileRemoved(*storage_context, source);
+	OnFileWritten(*storage_context, target);
+}
+
+bool AzureDfsStorageFileSystem::ListFiles(const string &directory,
+                                          const std::function<void(const string &, bool)> &callback,
+                                          FileOpener *opener) {
+	auto parsed_url = ParseUrl(directory);
+	auto path = DfsPath(parsed_url);
+	auto storage_context = GetOrCreateStorageContext(opener, directory, parsed_url);
+	auto file_system_client = storage_context->As<AzureDfsContextState>().GetDfsFileSystemClient(parsed_url.container);
+
+	Azure::Storage::Files::DataLake::ListPathsOptions options;
+	try {
+		auto directory_client = file_system_client.GetDirectoryClient(path);
+		while (true) {
+			auto res = directory_client.ListPaths(false, options, storage_context->request_context);
+			for (const auto &elt : res.Paths) {
+				// Names are relative to the file system root
+				auto name = path.empty() ? elt.Name : elt.Name.substr(path.length() + 1);
+				callback(name, elt.IsDirectory);
+			}
+			if (res.NextPageToken) {
+				options.ContinuationToken = res.NextPageToken;
+			} else {
+				break;
+			}
+		}
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound) {
+			return false;
+		}
+		throw IOException("AzureDfsStorageFileSystem could not list directory '%s': %s Reason Phrase: %s", directory,
+		                  e.ErrorCode, e.ReasonPhrase);
+	}
+	return true;
+}
+
 shared_ptr<AzureContextState> AzureDfsStorageFileSystem::CreateStorageContext(optional_ptr<FileOpener> opener,
                                                                               const string &path,
                                                                               const AzureParsedUrl &parsed_url) {
 	auto azure_read_options = ParseAzureReadOptions(opener);
+	auto azure_write_options = ParseAzureWriteOptions(opener);
 
 	return make_shared_ptr<AzureDfsContextState>(ConnectToDfsStorageAccount(opener, path, parsed_url),
-	                                             azure_read_options);
+	                                             azure_read_options, azure_write_options, GetHttpState(opener));
 }
 
 } // namespace duckdb
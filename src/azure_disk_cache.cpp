@@ -0,0 +1,450 @@
+#include "azure_disk_cache.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/uuid.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace duckdb {
+
+static constexpr const char *BLOCK_FILE_MAGIC = "AZBLOCK1";
+static constexpr idx_t BLOCK_FILE_MAGIC_SIZE = 8;
+static constexpr const char *BLOCK_FILE_EXTENSION = ".block";
+static constexpr const char *TMP_FILE_EXTENSION = ".tmp";
+
+constexpr idx_t AzureDiskCache::MAX_PENDING_WRITE_BYTES;
+constexpr idx_t AzureDiskCache::IDLE_TIMEOUT_MS;
+
+AzureDiskCache::AzureDiskCache()
+    : local_fs(FileSystem::CreateLocal()), max_size(0), eviction(AzureDiskCacheEviction::LRU), index_loaded(false),
+      disabled(false), size(0), next_order(0), pending_write_bytes(0), writer_running(false), writing(false),
+      shutdown(false) {
+}
+
+AzureDiskCache::~AzureDiskCache() {
+	{
+		lock_guard<mutex> guard(lock);
+		shutdown = true;
+		pending_writes.clear();
+		pending_file_names.clear();
+	}
+	writes_changed.notify_all();
+	if (writer.joinable()) {
+		writer.join();
+	}
+}
+
+shared_ptr<AzureDiskCache> AzureDiskCache::GetCache(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureDiskCache>(ObjectType());
+}
+
+AzureDiskCacheEviction AzureDiskCache::ParseEviction(const std::string &eviction) {
+	auto lower_eviction = StringUtil::Lower(eviction);
+	if (lower_eviction == "lru") {
+		return AzureDiskCacheEviction::LRU;
+	} else if (lower_eviction == "fifo") {
+		return AzureDiskCacheEviction::FIFO;
+	}
+	throw InvalidInputException("Unknown Azure disk cache eviction policy '%s', valid values are: lru, fifo",
+	                            eviction);
+}
+
+void AzureDiskCache::Configure(const std::string &new_directory, idx_t new_max_size,
+                               AzureDiskCacheEviction new_eviction) {
+	lock_guard<mutex> guard(lock);
+	if (new_directory != directory) {
+		// The queued blocks were read with the previous configuration, they are not worth writing in the new one
+		pending_writes.clear();
+		pending_file_names.clear();
+		pending_write_bytes = 0;
+		directory = new_directory;
+		index_loaded = false;
+		disabled = false;
+		entries.clear();
+		eviction_order.clear();
+		size = 0;
+	}
+	max_size = new_max_size;
+	eviction = new_eviction;
+	if (index_loaded) {
+		EvictUntil(max_size);
+	}
+}
+
+std::string AzureDiskCache::FileName(const std::string &key) {
+	return std::to_string(Hash(key.c_str(), key.size())) + BLOCK_FILE_EXTENSION;
+}
+
+//! Create the directory and its missing parents
+static void CreateDirectories(FileSystem &fs, const std::string &directory) {
+	auto separator = fs.PathSeparator(directory);
+	auto position = directory.find(separator, 1);
+	while (true) {
+		auto prefix = directory.substr(0, position);
+		if (!fs.DirectoryExists(prefix)) {
+			fs.CreateDirectory(prefix);
+		}
+		if (position == std::string::npos) {
+			return;
+		}
+		position = directory.find(separator, position + 1);
+	}
+}
+
+void AzureDiskCache::LoadIndex() {
+	if (index_loaded || disabled || directory.empty()) {
+		return;
+	}
+	index_loaded = true;
+	try {
+		ScanDirectory();
+	} catch (const std::exception &) {
+		// Not a directory, no permission... the cache is only an optimization, the reads still work without it
+		Disable();
+	}
+}
+
+void AzureDiskCache::Disable() {
+	disabled = true;
+	pending_writes.clear();
+	pending_file_names.clear();
+	pending_write_bytes = 0;
+	entries.clear();
+	eviction_order.clear();
+	size = 0;
+}
+
+void AzureDiskCache::ScanDirectory() {
+	if (!local_fs->DirectoryExists(directory)) {
+		CreateDirectories(*local_fs, directory);
+		return;
+	}
+
+	// Blocks already in the directory are ordered by their last write, it is the best approximation we have of
+	// the last access after a restart
+	struct ExistingBlock {
+		std::string file_name;
+		idx_t size;
+		time_t last_modified;
+	};
+	vector<ExistingBlock> existing_blocks;
+	vector<std::string> tmp_files;
+	local_fs->ListFiles(directory, [&](const string &file_name, bool is_directory) {
+		if (is_directory) {
+			return;
+		}
+		if (StringUtil::EndsWith(file_name, TMP_FILE_EXTENSION)) {
+			tmp_files.push_back(file_name);
+		} else if (StringUtil::EndsWith(file_name, BLOCK_FILE_EXTENSION)) {
+			existing_blocks.push_back({file_name, 0, 0});
+		}
+	});
+
+	// Left over by a process that stopped while writing a block
+	for (auto &tmp_file : tmp_files) {
+		RemoveFile(tmp_file);
+	}
+
+	for (auto &block : existing_blocks) {
+		auto handle = local_fs->OpenFile(local_fs->JoinPath(directory, block.file_name), FileFlags::FILE_FLAGS_READ);
+		block.size = static_cast<idx_t>(local_fs->GetFileSize(*handle));
+		block.last_modified = local_fs->GetLastModifiedTime(*handle);
+	}
+	std::sort(existing_blocks.begin(), existing_blocks.end(),
+	          [](const ExistingBlock &a, const ExistingBlock &b) { return a.last_modified < b.last_modified; });
+
+	for (auto &block : existing_blocks) {
+		auto order = next_order++;
+		entries[block.file_name] = CacheEntry {block.size, order};
+		eviction_order[order] = block.file_name;
+		size += block.size;
+	}
+	EvictUntil(max_size);
+}
+
+bool AzureDiskCache::Read(const std::string &key, unique_ptr<data_t[]> &data, idx_t &length) {
+	auto file_name = FileName(key);
+	std::string file_path;
+	{
+		lock_guard<mutex> guard(lock);
+		LoadIndex();
+		auto entry = entries.find(file_name);
+		if (entry == entries.end()) {
+			miss_count++;
+			return false;
+		}
+		if (eviction == AzureDiskCacheEviction::LRU) {
+			eviction_order.erase(entry->second.order);
+			entry->second.order = next_order++;
+			eviction_order[entry->second.order] = file_name;
+		}
+		file_path = local_fs->JoinPath(directory, file_name);
+	}
+
+	try {
+		auto handle =
+		    local_fs->OpenFile(file_path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			// Removed behind our back
+			miss_count++;
+			return false;
+		}
+		auto file_size = static_cast<idx_t>(local_fs->GetFileSize(*handle));
+		auto header_size = BLOCK_FILE_MAGIC_SIZE + sizeof(uint32_t) + key.size();
+		if (file_size < header_size) {
+			miss_count++;
+			return false;
+		}
+
+		auto header = unique_ptr<data_t[]>(new data_t[header_size]);
+		handle->Read(header.get(), header_size, 0);
+		uint32_t key_size;
+		memcpy(&key_size, header.get() + BLOCK_FILE_MAGIC_SIZE, sizeof(uint32_t));
+		if (memcmp(header.get(), BLOCK_FILE_MAGIC, BLOCK_FILE_MAGIC_SIZE) != 0 || key_size != key.size() ||
+		    memcmp(header.get() + BLOCK_FILE_MAGIC_SIZE + sizeof(uint32_t), key.data(), key.size()) != 0) {
+			// Hash collision (or corrupted file), dropped so that the next write of this key replaces it
+			handle.reset();
+			lock_guard<mutex> guard(lock);
+			RemoveBlock(file_name);
+			miss_count++;
+			return false;
+		}
+
+		length = file_size - header_size;
+		data = unique_ptr<data_t[]>(new data_t[length]);
+		handle->Read(data.get(), length, header_size);
+	} catch (const std::exception &) {
+		lock_guard<mutex> guard(lock);
+		Disable();
+		miss_count++;
+		return false;
+	}
+
+	hit_count++;
+	return true;
+}
+
+bool AzureDiskCache::Contains(const std::string &key) {
+	lock_guard<mutex> guard(lock);
+	LoadIndex();
+	return entries.find(FileName(key)) != entries.end();
+}
+
+void AzureDiskCache::Write(const std::string &key, const data_t *data, idx_t length) {
+	auto file_name = FileName(key);
+	auto file_size = BLOCK_FILE_MAGIC_SIZE + sizeof(uint32_t) + key.size() + length;
+	{
+		lock_guard<mutex> guard(lock);
+		LoadIndex();
+		if (disabled || directory.empty() || file_size > max_size) {
+			return;
+		}
+		if (entries.find(file_name) != entries.end() ||
+		    pending_file_names.find(file_name) != pending_file_names.end()) {
+			// Already stored (or about to be), e.g. by a concurrent read of the same block
+			return;
+		}
+		if (pending_write_bytes + length > MAX_PENDING_WRITE_BYTES) {
+			// The disk is slower than the network, the reads do not wait for it
+			return;
+		}
+
+		PendingWrite block;
+		block.key = key;
+		block.file_name = file_name;
+		block.data = unique_ptr<data_t[]>(new data_t[length]);
+		memcpy(block.data.get(), data, length);
+		block.length = length;
+		pending_writes.push_back(std::move(block));
+		pending_file_names.insert(file_name);
+		pending_write_bytes += length;
+		if (!writer_running) {
+			if (writer.joinable()) {
+				// It exited because it was idle, it does not use the lock anymore
+				writer.join();
+			}
+			writer_running = true;
+			writer = std::thread([this]() { WriteQueuedBlocks(); });
+		}
+	}
+	writes_changed.notify_all();
+}
+
+void AzureDiskCache::WriteQueuedBlocks() {
+	std::unique_lock<mutex> guard(lock);
+	while (!shutdown) {
+		if (pending_writes.empty()) {
+			auto has_block = writes_changed.wait_for(guard, std::chrono::milliseconds(IDLE_TIMEOUT_MS),
+			                                         [&]() { return shutdown || !pending_writes.empty(); });
+			if (!has_block) {
+				writer_running = false;
+				return;
+			}
+			continue;
+		}
+
+		auto block = std::move(pending_writes.front());
+		pending_writes.pop_front();
+		pending_write_bytes -= block.length;
+		writing = true;
+		guard.unlock();
+		WriteBlock(block);
+		guard.lock();
+		writing = false;
+		pending_file_names.erase(block.file_name);
+		writes_changed.notify_all();
+	}
+}
+
+void AzureDiskCache::WriteBlock(const PendingWrite &block) {
+	auto file_size = BLOCK_FILE_MAGIC_SIZE + sizeof(uint32_t) + block.key.size() + block.length;
+	std::string block_directory;
+	std::string file_path;
+	{
+		lock_guard<mutex> guard(lock);
+		if (disabled || directory.empty()) {
+			return;
+		}
+		block_directory = directory;
+		file_path = local_fs->JoinPath(directory, block.file_name);
+	}
+
+	// Write a temporary file and rename it, a reader never sees a partially written block
+	auto tmp_path = file_path + "." + UUID::ToString(UUID::GenerateRandomUUID()) + TMP_FILE_EXTENSION;
+	try {
+		auto handle = local_fs->OpenFile(tmp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		auto key_size = static_cast<uint32_t>(block.key.size());
+		handle->Write((void *)BLOCK_FILE_MAGIC, BLOCK_FILE_MAGIC_SIZE);
+		handle->Write(&key_size, sizeof(uint32_t));
+		handle->Write((void *)block.key.data(), block.key.size());
+		handle->Write((void *)block.data.get(), block.length);
+	} catch (const std::exception &) {
+		try {
+			local_fs->RemoveFile(tmp_path);
+		} catch (...) {
+		}
+		lock_guard<mutex> guard(lock);
+		Disable();
+		return;
+	}
+
+	try {
+		try {
+			local_fs->MoveFile(tmp_path, file_path);
+		} catch (const std::exception &) {
+			if (!local_fs->FileExists(file_path)) {
+				throw;
+			}
+			// Windows does not rename onto an existing file, e.g. a colliding block or one written by another
+			// process
+			local_fs->RemoveFile(file_path);
+			local_fs->MoveFile(tmp_path, file_path);
+		}
+	} catch (const std::exception &) {
+		// The existing block may be open by a reader, this one is simply not cached
+		try {
+			local_fs->RemoveFile(tmp_path);
+		} catch (...) {
+		}
+		return;
+	}
+
+	lock_guard<mutex> guard(lock);
+	if (disabled || directory != block_directory) {
+		return;
+	}
+	auto entry = entries.find(block.file_name);
+	if (entry != entries.end()) {
+		size -= entry->second.size;
+		eviction_order.erase(entry->second.order);
+	}
+	auto order = next_order++;
+	entries[block.file_name] = CacheEntry {file_size, order};
+	eviction_order[order] = block.file_name;
+	size += file_size;
+	EvictUntil(max_size);
+}
+
+void AzureDiskCache::Flush() {
+	std::unique_lock<mutex> guard(lock);
+	writes_changed.wait(guard, [&]() { return pending_writes.empty() && !writing; });
+}
+
+void AzureDiskCache::EvictUntil(idx_t target_size) {
+	while (size > target_size && !eviction_order.empty()) {
+		auto oldest = eviction_order.begin();
+		auto entry = entries.find(oldest->second);
+		D_ASSERT(entry != entries.end());
+		size -= entry->second.size;
+		RemoveFile(oldest->second);
+		entries.erase(entry);
+		eviction_order.erase(oldest);
+	}
+}
+
+void AzureDiskCache::RemoveBlock(const std::string &file_name) {
+	auto entry = entries.find(file_name);
+	if (entry == entries.end()) {
+		return;
+	}
+	size -= entry->second.size;
+	eviction_order.erase(entry->second.order);
+	entries.erase(entry);
+	RemoveFile(file_name);
+}
+
+void AzureDiskCache::RemoveFile(const std::string &file_name) {
+	try {
+		local_fs->RemoveFile(local_fs->JoinPath(directory, file_name));
+	} catch (...) {
+		// Already removed
+	}
+}
+
+void AzureDiskCache::Clear() {
+	std::unique_lock<mutex> guard(lock);
+	pending_writes.clear();
+	pending_file_names.clear();
+	pending_write_bytes = 0;
+	// The block being written would be indexed after the others are removed
+	writes_changed.wait(guard, [&]() { return !writing; });
+	LoadIndex();
+	EvictUntil(0);
+}
+
+std::string AzureDiskCache::GetDirectory() {
+	lock_guard<mutex> guard(lock);
+	return directory;
+}
+
+idx_t AzureDiskCache::GetCapacity() {
+	lock_guard<mutex> guard(lock);
+	return max_size;
+}
+
+idx_t AzureDiskCache::GetSize() {
+	lock_guard<mutex> guard(lock);
+	LoadIndex();
+	return size;
+}
+
+idx_t AzureDiskCache::GetBlockCount() {
+	lock_guard<mutex> guard(lock);
+	LoadIndex();
+	return entries.size();
+}
+
+string AzureDiskCache::ObjectType() {
+	return "azure_disk_cache";
+}
+
+string AzureDiskCache::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -2,8 +2,10 @@
 
 #include "azure_extension.hpp"
 #include "azure_blob_filesystem.hpp"
+#include "azure_cache_functions.hpp"
 #include "azure_dfs_filesystem.hpp"
 #include "azure_secret.hpp"
+#include "azure_stats_functions.hpp"
 
 namespace duckdb {
 
@@ -16,6 +18,12 @@ static void LoadInternal(DatabaseInstance &instance) {
 	// Load Secret functions
 	CreateAzureSecretFunctions::Register(instance);
 
+	// Load cache functions
+	AzureCacheFunctions::Register(instance);
+
+	// Load request stats functions
+	AzureStatsFunctions::Register(instance);
+
 	// Load extension config
 	auto &config = DBConfig::GetConfig(instance);
 	config.AddExtensionOption("azure_storage_connection_string",
@@ -42,11 +50,42 @@ static void LoadInternal(DatabaseInstance &instance) {
 	                          "If you suspect that the caching is causing some side effect you can try to disable it "
 	                          "by setting this option to false.",
 	                          LogicalType::BOOLEAN, true);
+	config.AddExtensionOption("azure_client_pooling",
+	                          "Enable/disable the sharing of the Azure storage clients between queries and "
+	                          "connections. When enabled, the clients (and so their connections and tokens) are kept "
+	                          "for the database lifetime and reused as long as the secret and the azure_* settings "
+	                          "used to build them do not change.",
+	                          LogicalType::BOOLEAN, true);
+	config.AddExtensionOption("azure_list_concurrency",
+	                          "Maximum number of concurrent list requests used to expand a glob. For abfss globs the "
+	                          "matching directories are listed concurrently. When greater than 1, blob globs are "
+	                          "expanded one directory level at a time (hierarchical listing) and the directories that "
+	                          "can match are listed concurrently.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(1));
+	config.AddExtensionOption("azure_metadata_prefetch_concurrency",
+	                          "Maximum number of concurrent requests fetching the info of the files of a list given to "
+	                          "a multi-file reader (e.g. read_parquet(['az://...', ...])), while the list is expanded. "
+	                          "Opening the files then does not need a request. 0 disables the prefetch.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("azure_not_found_cache_ttl",
+	                          "Time (in milliseconds) during which a file found missing is remembered, probing it "
+	                          "again (e.g. optional files, existence checks) does not send a request. Files written "
+	                          "through DuckDB are forgotten immediately. 0 disables the cache.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("azure_request_log_size",
+	                          "Number of HTTP requests kept in the request log, queryable with azure_request_log(). "
+	                          "Every attempt (retries included) sent to Azure is traced. 0 disables the log.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
 	config.AddExtensionOption("azure_transport_option_type",
 	                          "Underlying adapter to use with the Azure SDK. Read more about the adapter at "
 	                          "https://github.com/Azure/azure-sdk-for-cpp/blob/main/doc/HttpTransportAdapter.md. Valid "
 	                          "values are: default, curl",
 	                          LogicalType::VARCHAR, "default");
+	config.AddExtensionOption("azure_http_pool_size",
+	                          "Maximum number of requests in flight at once on the HTTP transport, shared by all the "
+	                          "clients with the same transport settings in the process, and so of connections it keeps "
+	                          "open. Requests wait for a free slot beyond it. 0 for unlimited.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
 
 	AzureReadOptions default_read_options;
 	config.AddExtensionOption("azure_read_transfer_concurrency",
@@ -65,6 +104,99 @@ static void LoadInternal(DatabaseInstance &instance) {
 	                          "azure_read_transfer_chunk_size.",
 	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.buffer_size));
 
+	config.AddExtensionOption("azure_read_ahead_depth",
+	                          "Number of buffers of azure_read_buffer_size bytes downloaded in the background ahead "
+	                          "of a sequential read (e.g. CSV or JSON scans). 0 disables the read-ahead.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.read_ahead_depth));
+
+	config.AddExtensionOption("azure_read_ahead_trigger",
+	                          "Number of consecutive sequential buffer refills of a file needed before the read-ahead "
+	                          "starts.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.read_ahead_trigger));
+
+	config.AddExtensionOption("azure_read_small_file_threshold",
+	                          "Files up to this size are downloaded with a single request when they are opened, "
+	                          "replacing the HEAD request, and all their reads are served from memory. 0 disables it.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.small_file_threshold));
+
+	config.AddExtensionOption("azure_read_tail_prefetch_size",
+	                          "Number of bytes fetched from the end of a Parquet file when it is opened, so that the "
+	                          "footer length and the footer are read with a single request. When the file has been "
+	                          "listed by a glob it also replaces the HEAD request. 0 disables the prefetch.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.tail_prefetch_size));
+
+	config.AddExtensionOption("azure_read_lazy_open",
+	                          "Open the files without a HEAD request. Their info is loaded by the first read, with the "
+	                          "GET of its data when it starts at the beginning of the file, or by the first size "
+	                          "request.",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(default_read_options.lazy_open));
+
+	config.AddExtensionOption("azure_account_max_in_flight",
+	                          "Maximum number of requests in flight to a storage account, shared by all the "
+	                          "connections. Throttling responses (429/503) halve the limit and pause the requests to "
+	                          "the account, it then ramps back up. 0 disables the governor.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("azure_account_max_request_rate",
+	                          "Maximum number of requests per second sent to a storage account when "
+	                          "azure_account_max_in_flight is set. 0 means unlimited.",
+	                          LogicalType::DOUBLE, Value::DOUBLE(0));
+
+	config.AddExtensionOption("azure_read_adaptive_transfer",
+	                          "Tune the transfer concurrency and chunk size of each storage account from the measured "
+	                          "throughput and latency of the downloads (AIMD), starting from "
+	                          "azure_read_transfer_concurrency and azure_read_transfer_chunk_size.",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(default_read_options.adaptive_transfer));
+
+	config.AddExtensionOption("azure_read_hedge_percentile",
+	                          "Percentile (between 0 and 1, e.g. 0.95) of the recent download latencies of a storage "
+	                          "account after which a range download is duplicated, the first response is used and "
+	                          "the other request is cancelled. 0 disables the hedging.",
+	                          LogicalType::DOUBLE, Value::DOUBLE(default_read_options.hedge_percentile));
+
+	config.AddExtensionOption("azure_read_hedge_budget",
+	                          "Maximum fraction of the range downloads of a storage account that can be hedged.",
+	                          LogicalType::DOUBLE, Value::DOUBLE(default_read_options.hedge_budget));
+
+	config.AddExtensionOption("azure_read_coalesce_gap",
+	                          "Unbuffered reads (e.g. Parquet column chunks) smaller than this size also download up "
+	                          "to this many following bytes, so the reads of nearby ranges are served by the same "
+	                          "request. 0 disables the coalescing.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.coalesce_gap));
+
+	config.AddExtensionOption("azure_block_cache_size",
+	                          "Memory (in bytes) the database can use to keep the blocks read from Azure files, it is "
+	                          "accounted in the memory limit. Blocks are validated with the file ETag. 0 disables the "
+	                          "cache.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.block_cache_size));
+
+	config.AddExtensionOption("azure_block_cache_block_size",
+	                          "Size of the blocks kept in the Azure block cache, reads are aligned on this size when "
+	                          "the cache is enabled.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.block_cache_block_size));
+
+	config.AddExtensionOption("azure_disk_cache_directory",
+	                          "Local directory where the blocks read from Azure files are persisted, so they can be "
+	                          "reused across process restarts. Blocks are validated with the file ETag and last "
+	                          "modification time. Unset disables the disk cache.",
+	                          LogicalType::VARCHAR, Value(nullptr));
+
+	config.AddExtensionOption("azure_disk_cache_max_size", "Maximum disk space (in bytes) used by the disk cache.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_read_options.disk_cache_max_size));
+
+	config.AddExtensionOption("azure_disk_cache_eviction",
+	                          "Eviction policy of the disk cache. Valid values are: lru, fifo",
+	                          LogicalType::VARCHAR, "lru");
+
+	AzureWriteOptions default_write_options;
+	config.AddExtensionOption("azure_write_block_size",
+	                          "Size of the blocks uploaded when writing to Azure. The blocks are uploaded while the "
+	                          "next ones are produced, a blob can have at most 50000 blocks.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_write_options.block_size));
+
+	config.AddExtensionOption("azure_write_upload_concurrency",
+	                          "Maximum number of blocks uploaded concurrently by each written file.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(default_write_options.upload_concurrency));
+
 	auto *http_proxy = std::getenv("HTTP_PROXY");
 	Value default_http_value = http_proxy ? Value(http_proxy) : Value(nullptr);
 	config.AddExtensionOption("azure_http_proxy",
@@ -1,14 +1,30 @@
 #include "azure_filesystem.hpp"
+#include "azure_throttling_policy.hpp"
+#include "http_state_policy.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 #include <azure/storage/common/storage_exception.hpp>
+#include <thread>
 
 namespace duckdb {
 
-AzureContextState::AzureContextState(const AzureReadOptions &read_options)
-    : read_options(read_options), is_valid(true) {
+static Azure::Core::Context CreateRequestContext(const shared_ptr<AzureHTTPState> &http_state) {
+	Azure::Core::Context context;
+	if (http_state) {
+		context = HttpStatePolicy::AttachHttpState(context, http_state);
+	}
+	return context;
+}
+
+AzureContextState::AzureContextState(const AzureReadOptions &read_options, const AzureWriteOptions &write_options,
+                                     shared_ptr<AzureHTTPState> http_state)
+    : read_options(read_options), write_options(write_options), http_state(std::move(http_state)),
+      request_context(CreateRequestContext(this->http_state)),
+      read_buffer_pool(make_shared_ptr<AzureReadBufferPool>(nullptr)), is_valid(true) {
 }
 
 bool AzureContextState::IsValid() const {
@@ -17,54 +33,348 @@ bool AzureContextState::IsValid() const {
 
 void AzureContextState::QueryEnd() {
 	is_valid = false;
+	// The next query uses a new context, the idle read buffers would stay pinned for nothing
+	read_buffer_pool->Close();
+	if (metadata_prefetcher) {
+		metadata_prefetcher->Cancel(*this);
+	}
+}
+
+void AzureContextState::AddFileMetadata(const string &path, AzureFileMetadata metadata) {
+	lock_guard<mutex> guard(metadata_lock);
+	file_metadata[path] = std::move(metadata);
+}
+
+bool AzureContextState::TryGetFileMetadata(const string &path, AzureFileMetadata &metadata) const {
+	lock_guard<mutex> guard(metadata_lock);
+	auto entry = file_metadata.find(path);
+	if (entry == file_metadata.end()) {
+		return false;
+	}
+	metadata = entry->second;
+	return true;
+}
+
+void AzureContextState::RemoveFileMetadata(const string &path) {
+	lock_guard<mutex> guard(metadata_lock);
+	file_metadata.erase(path);
 }
 
 AzureFileHandle::AzureFileHandle(AzureStorageFileSystem &fs, string path, FileOpenFlags flags,
-                                 const AzureReadOptions &read_options)
+                                 shared_ptr<AzureContextState> storage_context_p)
     : FileHandle(fs, std::move(path), flags), flags(flags),
       // File info
-      length(0), last_modified(0),
+      length(0), last_modified(0), file_info_pending(false),
       // Read info
       buffer_available(0), buffer_idx(0), file_offset(0), buffer_start(0), buffer_end(0),
+      // Read-ahead info
+      sequential_refill_count(0),
+      // Prefetched data
+      prefetched_start(0), prefetched_length(0),
+      // Write info
+      write_buffer_length(0), block_count(0), uploaded_length(0),
+      committed_length(DConstants::INVALID_INDEX), write_finished(false),
       // Options
-      read_options(read_options) {
-	if (!flags.RequireParallelAccess() && !flags.DirectIO()) {
-		read_buffer = duckdb::unique_ptr<data_t[]>(new data_t[read_options.buffer_size]);
-	}
+      read_options(storage_context_p->read_options), write_options(storage_context_p->write_options),
+      storage_context(std::move(storage_context_p)) {
+}
+
+bool AzureFileHandle::HasWholeFile() const {
+	return prefetched_data && prefetched_start == 0 && prefetched_length == length;
 }
 
 bool AzureFileHandle::PostConstruct() {
 	return static_cast<AzureStorageFileSystem &>(file_system).LoadFileInfo(*this);
 }
 
+void AzureFileHandle::Close() {
+	StopReads();
+	if (flags.OpenForWriting() && !write_finished) {
+		static_cast<AzureStorageFileSystem &>(file_system).FinishWrite(*this);
+	}
+}
+
+void AzureFileHandle::Discard() {
+	StopReads();
+	if (flags.OpenForWriting() && !write_finished) {
+		static_cast<AzureStorageFileSystem &>(file_system).AbortWrite(*this);
+	}
+}
+
+void AzureFileHandle::StopReads() {
+	// Wait for the background downloads, they use the handle
+	if (read_ahead) {
+		auto wasted_bytes = read_ahead->Cancel();
+		if (storage_context->http_state) {
+			storage_context->http_state->read_ahead_wasted_bytes += wasted_bytes;
+		}
+		read_ahead.reset();
+	}
+	storage_context->read_buffer_pool->Release(std::move(read_buffer));
+	buffer_available = 0;
+	buffer_idx = 0;
+	buffer_start = 0;
+	buffer_end = 0;
+}
+
 bool AzureStorageFileSystem::LoadFileInfo(AzureFileHandle &handle) {
-	if (handle.flags.OpenForReading()) {
-		try {
-			LoadRemoteFileInfo(handle);
-		} catch (const Azure::Storage::StorageException &e) {
-			auto status_code = int(e.StatusCode);
-			if (status_code == 404 && handle.flags.ReturnNullIfNotExists()) {
+	if (!handle.flags.OpenForReading()) {
+		return true;
+	}
+
+	// The file has been listed by a glob of the current query or its info is being prefetched, no need to ask for
+	// its properties
+	metadata_prefetcher.Wait(*handle.storage_context, handle.path);
+	AzureFileMetadata metadata;
+	bool listed = handle.storage_context->TryGetFileMetadata(handle.path, metadata);
+	if (listed) {
+		handle.length = metadata.length;
+		handle.last_modified = metadata.last_modified;
+		handle.etag = std::move(metadata.etag);
+	} else {
+		auto &not_found_cache = handle.storage_context->not_found_cache;
+		if (not_found_cache && not_found_cache->Contains(handle.path)) {
+			if (handle.storage_context->http_state) {
+				handle.storage_context->http_state->not_found_cache_hit_count++;
+			}
+			if (handle.flags.ReturnNullIfNotExists()) {
+				return false;
+			}
+			throw IOException("AzureBlobStorageFileSystem open file '%s' failed, the file was not found by a recent "
+			                  "request",
+			                  handle.path);
+		}
+		// Whether the file exists must be known at open when the caller accepts a missing file, and the parallel
+		// reads of a handle cannot load the info concurrently
+		if (handle.read_options.lazy_open && !handle.flags.ReturnNullIfNotExists() &&
+		    !handle.flags.RequireParallelAccess()) {
+			handle.file_info_pending = true;
+			return true;
+		}
+		auto loaded = TryLoadFileInfo(handle, [&]() {
+			if (handle.read_options.small_file_threshold > 0) {
+				LoadFileInfoAndPrefix(handle, handle.read_options.small_file_threshold);
+			} else {
+				LoadRemoteFileInfo(handle);
+			}
+		});
+		if (!loaded) {
+			return false;
+		}
+	}
+
+	if (listed && handle.length > 0 && handle.length <= handle.read_options.small_file_threshold) {
+		// Small file, its size is already known: download it at once
+		auto prefetched_data = duckdb::unique_ptr<data_t[]>(new data_t[handle.length]);
+		ReadRange(handle, 0, (char *)prefetched_data.get(), handle.length);
+		handle.prefetched_data = std::move(prefetched_data);
+		handle.prefetched_start = 0;
+		handle.prefetched_length = handle.length;
+	}
+
+	if (!handle.HasWholeFile()) {
+		PrefetchTail(handle);
+	}
+	return true;
+}
+
+bool AzureStorageFileSystem::TryLoadFileInfo(AzureFileHandle &handle, const std::function<void()> &load) {
+	try {
+		load();
+	} catch (const Azure::Storage::StorageException &e) {
+		auto status_code = int(e.StatusCode);
+		if (status_code == 404) {
+			OnFileNotFound(*handle.storage_context, handle.path);
+			if (handle.flags.ReturnNullIfNotExists()) {
 				return false;
 			}
-			throw IOException(
-			    "AzureBlobStorageFileSystem open file '%s' failed with code'%s', Reason Phrase: '%s', Message: '%s'",
-			    handle.path, e.ErrorCode, e.ReasonPhrase, e.Message);
-		} catch (const std::exception &e) {
-			throw IOException(
-			    "AzureBlobStorageFileSystem could not open file: '%s', unknown error occurred, this could mean "
-			    "the credentials used were wrong. Original error message: '%s' ",
-			    handle.path, e.what());
 		}
+		throw IOException(
+		    "AzureBlobStorageFileSystem open file '%s' failed with code'%s', Reason Phrase: '%s', Message: '%s'",
+		    handle.path, e.ErrorCode, e.ReasonPhrase, e.Message);
+	} catch (const std::exception &e) {
+		throw IOException("AzureBlobStorageFileSystem could not open file: '%s', unknown error occurred, this could "
+		                  "mean the credentials used were wrong. Original error message: '%s' ",
+		                  handle.path, e.what());
 	}
 	return true;
 }
 
+void AzureStorageFileSystem::LoadPendingFileInfo(AzureFileHandle &handle) {
+	if (!handle.file_info_pending) {
+		return;
+	}
+	TryLoadFileInfo(handle, [&]() {
+		if (handle.read_options.small_file_threshold > 0) {
+			LoadFileInfoAndPrefix(handle, handle.read_options.small_file_threshold);
+		} else {
+			LoadRemoteFileInfo(handle);
+		}
+	});
+	handle.file_info_pending = false;
+	if (!handle.HasWholeFile()) {
+		PrefetchTail(handle);
+	}
+}
+
+idx_t AzureStorageFileSystem::ReadWithPendingFileInfo(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len,
+                                                      idx_t location) {
+	D_ASSERT(handle.file_info_pending);
+	if (location != 0) {
+		LoadPendingFileInfo(handle);
+		return 0;
+	}
+
+	// The GET of the first bytes answers with the file info, no HEAD needed
+	idx_t read_length = 0;
+	TryLoadFileInfo(handle, [&]() {
+		if (buffer_out_len >= handle.read_options.buffer_size) {
+			read_length = LoadFileInfoWithRange(handle, buffer_out, buffer_out_len);
+		} else {
+			// Keep a buffer worth of data for the next reads
+			LoadFileInfoAndPrefix(handle, MaxValue<idx_t>(handle.read_options.buffer_size,
+			                                              handle.read_options.small_file_threshold));
+		}
+	});
+	handle.file_info_pending = false;
+	return read_length;
+}
+
+void AzureStorageFileSystem::PrefetchFileMetadata(const vector<string> &paths, optional_ptr<FileOpener> opener) {
+	Value value;
+	idx_t concurrency = 0;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_metadata_prefetch_concurrency", value)) {
+		concurrency = value.GetValue<idx_t>();
+	}
+	bool azure_context_caching = true;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_context_caching", value)) {
+		azure_context_caching = value.GetValue<bool>();
+	}
+	// Without caching the files would be opened with another storage context, not knowing the fetched info
+	if (concurrency == 0 || !azure_context_caching || !FileOpener::TryGetClientContext(opener)) {
+		return;
+	}
+
+	for (const auto &path : paths) {
+		auto parsed_url = ParseUrl(path);
+		auto storage_context = GetOrCreateStorageContext(opener, path, parsed_url);
+		AzureFileMetadata metadata;
+		if (storage_context->TryGetFileMetadata(path, metadata)) {
+			continue;
+		}
+		metadata_prefetcher.Schedule(storage_context, {path}, concurrency);
+	}
+}
+
+void AzureStorageFileSystem::FetchFileMetadata(AzureContextState &storage_context, const string &path) {
+	if (!storage_context.IsValid()) {
+		// The query is over
+		return;
+	}
+	if (storage_context.http_state) {
+		storage_context.http_state->metadata_prefetch_count++;
+	}
+	try {
+		AzureFileMetadata metadata;
+		if (LoadRemoteFileMetadata(storage_context, path, metadata)) {
+			storage_context.AddFileMetadata(path, std::move(metadata));
+		}
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound) {
+			OnFileNotFound(storage_context, path);
+		}
+		throw;
+	}
+}
+
+bool AzureStorageFileSystem::TryGetKnownExistence(AzureContextState &storage_context, const string &path,
+                                                  bool &exists, AzureFileMetadata &metadata) {
+	if (storage_context.TryGetFileMetadata(path, metadata)) {
+		if (storage_context.http_state) {
+			storage_context.http_state->exists_from_listing_count++;
+		}
+		exists = true;
+		return true;
+	}
+	if (storage_context.not_found_cache && storage_context.not_found_cache->Contains(path)) {
+		if (storage_context.http_state) {
+			storage_context.http_state->not_found_cache_hit_count++;
+		}
+		exists = false;
+		return true;
+	}
+	return false;
+}
+
+void AzureStorageFileSystem::OnFileNotFound(AzureContextState &storage_context, const string &path) {
+	if (storage_context.not_found_cache) {
+		storage_context.not_found_cache->Add(path);
+	}
+}
+
+void AzureStorageFileSystem::OnFileWritten(AzureContextState &storage_context, const string &path) {
+	storage_context.RemoveFileMetadata(path);
+	if (storage_context.not_found_cache) {
+		storage_context.not_found_cache->Remove(path);
+	}
+}
+
+void AzureStorageFileSystem::OnFileRemoved(AzureContextState &storage_context, const string &path) {
+	storage_context.RemoveFileMetadata(path);
+	OnFileNotFound(storage_context, path);
+}
+
+idx_t AzureStorageFileSystem::LoadFileInfoWithRange(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len) {
+	try {
+		return LoadRemoteFileInfoWithRange(handle, buffer_out, buffer_out_len);
+	} catch (const Azure::Storage::StorageException &e) {
+		if (e.StatusCode != Azure::Core::Http::HttpStatusCode::RangeNotSatisfiable) {
+			throw;
+		}
+		// No range can be satisfied by an empty file
+		LoadRemoteFileInfo(handle);
+		return 0;
+	}
+}
+
+void AzureStorageFileSystem::LoadFileInfoAndPrefix(AzureFileHandle &handle, idx_t prefix_size) {
+	// A ranged GET answers with the properties of the file, it replaces the HEAD request and fetches the whole
+	// file when it is smaller than the prefix
+	auto prefix_data = duckdb::unique_ptr<data_t[]>(new data_t[prefix_size]);
+	auto prefix_length = LoadFileInfoWithRange(handle, (char *)prefix_data.get(), prefix_size);
+	if (prefix_length == 0) {
+		return;
+	}
+	handle.prefetched_data = std::move(prefix_data);
+	handle.prefetched_start = 0;
+	handle.prefetched_length = prefix_length;
+}
+
+void AzureStorageFileSystem::PrefetchTail(AzureFileHandle &handle) {
+	// Parquet readers start by reading the 8 last bytes then the footer, fetch both with a single request
+	auto prefetch_size = handle.read_options.tail_prefetch_size;
+	if (prefetch_size == 0 || handle.length == 0 || !StringUtil::EndsWith(StringUtil::Lower(handle.path), ".parquet")) {
+		return;
+	}
+	auto prefetch_length = MinValue<idx_t>(prefetch_size, handle.length);
+	auto prefetch_start = handle.length - prefetch_length;
+	auto prefetched_data = duckdb::unique_ptr<data_t[]>(new data_t[prefetch_length]);
+	ReadRange(handle, prefetch_start, (char *)prefetched_data.get(), prefetch_length);
+
+	handle.prefetched_data = std::move(prefetched_data);
+	handle.prefetched_start = prefetch_start;
+	handle.prefetched_length = prefetch_length;
+}
+
 unique_ptr<FileHandle> AzureStorageFileSystem::OpenFile(const string &path, FileOpenFlags flags,
                                                         optional_ptr<FileOpener> opener) {
 	D_ASSERT(flags.Compression() == FileCompressionType::UNCOMPRESSED);
 
-	if (flags.OpenForWriting()) {
-		throw NotImplementedException("Writing to Azure containers is currently not supported");
+	if (flags.OpenForWriting() && flags.OpenForReading()) {
+		throw NotImplementedException("Opening an Azure file for both reading and writing is not supported");
+	}
+	if (flags.OpenForAppending()) {
+		throw NotImplementedException("Appending to an Azure file is not supported");
 	}
 
 	auto handle = CreateHandle(path, flags, opener);
@@ -73,11 +383,13 @@ unique_ptr<FileHandle> AzureStorageFileSystem::OpenFile(const string &path, File
 
 int64_t AzureStorageFileSystem::GetFileSize(FileHandle &handle) {
 	auto &afh = handle.Cast<AzureFileHandle>();
+	LoadPendingFileInfo(afh);
 	return afh.length;
 }
 
 time_t AzureStorageFileSystem::GetLastModifiedTime(FileHandle &handle) {
 	auto &afh = handle.Cast<AzureFileHandle>();
+	LoadPendingFileInfo(afh);
 	return afh.last_modified;
 }
 
@@ -87,7 +399,110 @@ void AzureStorageFileSystem::Seek(FileHandle &handle, idx_t location) {
 }
 
 void AzureStorageFileSystem::FileSync(FileHandle &handle) {
-	throw NotImplementedException("FileSync for Azure Storage files not implemented");
+	auto &afh = handle.Cast<AzureFileHandle>();
+	if (!afh.flags.OpenForWriting()) {
+		throw NotImplementedException("FileSync for Azure Storage files not implemented");
+	}
+
+	// Everything written so far is committed, committing again later with more blocks is allowed
+	if (afh.write_buffer_length > 0) {
+		UploadWriteBuffer(afh);
+	}
+	WaitForUploads(afh, 0);
+	if (afh.committed_length != afh.length) {
+		CommitUpload(afh, afh.block_count, afh.length);
+		afh.committed_length = afh.length;
+		OnFileWritten(*afh.storage_context, afh.path);
+	}
+}
+
+void AzureStorageFileSystem::FinishWrite(AzureFileHandle &handle) {
+	if (Exception::UncaughtException()) {
+		// Closed while the write is failing, do not commit a partial file
+		AbortWrite(handle);
+		return;
+	}
+	handle.write_finished = true;
+	if (handle.committed_length != handle.length) {
+		FileSync(handle);
+	}
+}
+
+void AzureStorageFileSystem::AbortWrite(AzureFileHandle &handle) {
+	handle.write_finished = true;
+	handle.write_buffer.reset();
+	handle.write_buffer_length = 0;
+	while (!handle.uploads.empty()) {
+		auto upload = std::move(handle.uploads.front());
+		handle.uploads.pop_front();
+		try {
+			upload.get();
+		} catch (...) {
+			// The upload errors do not matter anymore, the data is dropped
+		}
+	}
+	CleanupAbortedUpload(handle);
+}
+
+void AzureStorageFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	auto &afh = handle.Cast<AzureFileHandle>();
+	if (!afh.flags.OpenForWriting()) {
+		throw InternalException("Write called on an Azure file not opened for writing");
+	}
+	if (location != afh.file_offset) {
+		throw NotImplementedException("Non-sequential writes to Azure files are not supported");
+	}
+
+	auto block_size = afh.write_options.block_size;
+	auto data = static_cast<const data_t *>(buffer);
+	idx_t written = 0;
+	while (written < idx_t(nr_bytes)) {
+		if (!afh.write_buffer) {
+			afh.write_buffer = duckdb::unique_ptr<data_t[]>(new data_t[block_size]);
+		}
+		auto to_copy = MinValue<idx_t>(block_size - afh.write_buffer_length, idx_t(nr_bytes) - written);
+		memcpy(afh.write_buffer.get() + afh.write_buffer_length, data + written, to_copy);
+		afh.write_buffer_length += to_copy;
+		written += to_copy;
+		if (afh.write_buffer_length == block_size) {
+			// Keep producing data while the block is uploaded
+			UploadWriteBuffer(afh);
+		}
+	}
+	afh.file_offset += written;
+	afh.length = afh.file_offset;
+}
+
+int64_t AzureStorageFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	auto &afh = handle.Cast<AzureFileHandle>();
+	Write(handle, buffer, nr_bytes, afh.file_offset);
+	return nr_bytes;
+}
+
+void AzureStorageFileSystem::UploadWriteBuffer(AzureFileHandle &handle) {
+	// Bound the memory used by the blocks in flight
+	WaitForUploads(handle, MaxValue<idx_t>(handle.write_options.upload_concurrency, 1) - 1);
+
+	auto block_idx = handle.block_count++;
+	auto block_offset = handle.uploaded_length;
+	auto block_length = handle.write_buffer_length;
+	handle.uploaded_length += block_length;
+	handle.write_buffer_length = 0;
+
+	// The buffer is owned by the upload until it completes, the next write allocates a new one
+	auto upload = [this, &handle, block_idx, block_offset, block_length,
+	               block_data = std::move(handle.write_buffer)]() {
+		UploadBlock(handle, block_idx, block_offset, block_data.get(), block_length);
+	};
+	handle.uploads.push_back(std::async(std::launch::async, std::move(upload)));
+}
+
+void AzureStorageFileSystem::WaitForUploads(AzureFileHandle &handle, idx_t max_uploads) {
+	while (handle.uploads.size() > max_uploads) {
+		auto upload = std::move(handle.uploads.front());
+		handle.uploads.pop_front();
+		upload.get();
+	}
 }
 
 // TODO: this code is identical to HTTPFS, look into unifying it
@@ -97,12 +512,32 @@ void AzureStorageFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_b
 	idx_t to_read = nr_bytes;
 	idx_t buffer_offset = 0;
 
+	if (hfh.file_info_pending) {
+		auto read_length = ReadWithPendingFileInfo(hfh, (char *)buffer, to_read, location);
+		if (read_length == to_read) {
+			hfh.file_offset = location + nr_bytes;
+			return;
+		}
+		// Otherwise the read goes past the end of the file, it fails below
+	}
+
+	// The whole file is in memory, no need to buffer
+	if (hfh.HasWholeFile()) {
+		ReadRange(hfh, location, (char *)buffer, to_read);
+		hfh.file_offset = location + nr_bytes;
+		return;
+	}
+
 	// Don't buffer when DirectIO is set.
 	if (hfh.flags.DirectIO() || hfh.flags.RequireParallelAccess()) {
 		if (to_read == 0) {
 			return;
 		}
-		ReadRange(hfh, location, (char *)buffer, to_read);
+		if (to_read < hfh.read_options.coalesce_gap) {
+			ReadCoalescedRange(hfh, location, (char *)buffer, to_read);
+		} else {
+			ReadRange(hfh, location, (char *)buffer, to_read);
+		}
 		hfh.buffer_available = 0;
 		hfh.buffer_idx = 0;
 		hfh.file_offset = location + nr_bytes;
@@ -119,11 +554,15 @@ void AzureStorageFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_b
 		hfh.buffer_idx = 0;
 		hfh.file_offset = location;
 	}
+	auto &http_state = hfh.storage_context->http_state;
 	while (to_read > 0) {
 		auto buffer_read_len = MinValue<idx_t>(hfh.buffer_available, to_read);
 		if (buffer_read_len > 0) {
 			D_ASSERT(hfh.buffer_start + hfh.buffer_idx + buffer_read_len <= hfh.buffer_end);
-			memcpy((char *)buffer + buffer_offset, hfh.read_buffer.get() + hfh.buffer_idx, buffer_read_len);
+			memcpy((char *)buffer + buffer_offset, hfh.read_buffer.Ptr() + hfh.buffer_idx, buffer_read_len);
+			if (http_state) {
+				http_state->read_buffer_copy_bytes += buffer_read_len;
+			}
 
 			buffer_offset += buffer_read_len;
 			to_read -= buffer_read_len;
@@ -134,28 +573,426 @@ void AzureStorageFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_b
 		}
 
 		if (to_read > 0 && hfh.buffer_available == 0) {
-			auto new_buffer_available = MinValue<idx_t>(hfh.read_options.buffer_size, hfh.length - hfh.file_offset);
+			const auto buffer_size = hfh.read_options.buffer_size;
+			const auto file_remaining = hfh.length - hfh.file_offset;
+
+			// Download the whole buffer sized part of the read straight into the caller buffer, only the unaligned
+			// tail goes through the read buffer, which then holds the next bytes for the following sequential read.
+			// When read-ahead is running the next buffers are already in flight, they are used instead.
+			idx_t direct_length = 0;
+			if (to_read > file_remaining) {
+				// Past the end of the file, the download reports the error
+				direct_length = to_read;
+			} else if (!hfh.read_ahead) {
+				direct_length = to_read == file_remaining ? to_read : to_read - to_read % buffer_size;
+			}
 
-			// Bypass buffer if we read more than buffer size
-			if (to_read > new_buffer_available) {
-				ReadRange(hfh, location + buffer_offset, (char *)buffer + buffer_offset, to_read);
+			if (direct_length > 0) {
+				ReadRange(hfh, hfh.file_offset, (char *)buffer + buffer_offset, direct_length);
+				buffer_offset += direct_length;
+				to_read -= direct_length;
+				hfh.file_offset += direct_length;
+				// Empty buffer ending at the current offset, the next refill is still seen as sequential
 				hfh.buffer_available = 0;
 				hfh.buffer_idx = 0;
-				hfh.file_offset += to_read;
-				break;
-			} else {
-				ReadRange(hfh, hfh.file_offset, (char *)hfh.read_buffer.get(), new_buffer_available);
-				hfh.buffer_available = new_buffer_available;
-				hfh.buffer_idx = 0;
 				hfh.buffer_start = hfh.file_offset;
-				hfh.buffer_end = hfh.buffer_start + new_buffer_available;
+				hfh.buffer_end = hfh.file_offset;
+			} else {
+				FillReadBuffer(hfh, MinValue<idx_t>(buffer_size, file_remaining));
+			}
+		}
+	}
+}
+
+void AzureStorageFileSystem::ReadCoalescedRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                                idx_t buffer_out_len) {
+	//! Number of ranges kept by a handle, there is usually one per thread reading the file
+	static constexpr idx_t MAX_COALESCED_RANGES = 8;
+	auto &http_state = handle.storage_context->http_state;
+	const auto range_end = file_offset + buffer_out_len;
+	if (range_end > handle.length) {
+		ReadRange(handle, file_offset, buffer_out, buffer_out_len);
+		return;
+	}
+
+	{
+		lock_guard<mutex> guard(handle.coalesce_lock);
+		for (auto &range : handle.coalesced_ranges) {
+			if (file_offset >= range.offset && range_end <= range.offset + range.length) {
+				memcpy(buffer_out, range.data.get() + (file_offset - range.offset), buffer_out_len);
+				if (http_state) {
+					http_state->coalesced_read_count++;
+				}
+				return;
+			}
+		}
+	}
+
+	// Merge the requested range and the following bytes in a single request
+	AzureFileHandle::CoalescedRange range;
+	range.offset = file_offset;
+	range.length = MinValue<idx_t>(buffer_out_len + handle.read_options.coalesce_gap, handle.length - file_offset);
+	range.data = duckdb::unique_ptr<data_t[]>(new data_t[range.length]);
+	ReadRange(handle, range.offset, (char *)range.data.get(), range.length);
+	memcpy(buffer_out, range.data.get(), buffer_out_len);
+
+	lock_guard<mutex> guard(handle.coalesce_lock);
+	handle.coalesced_ranges.push_front(std::move(range));
+	if (handle.coalesced_ranges.size() > MAX_COALESCED_RANGES) {
+		handle.coalesced_ranges.pop_back();
+	}
+}
+
+void AzureStorageFileSystem::FillReadBuffer(AzureFileHandle &hfh, idx_t length) {
+	auto &http_state = hfh.storage_context->http_state;
+
+	// Allocated on the first buffered read, small files served from memory never need it
+	if (!hfh.read_buffer) {
+		hfh.read_buffer = hfh.storage_context->read_buffer_pool->Allocate(hfh.read_options.buffer_size);
+	}
+
+	// Detect the sequential access: the new buffer starts where the previous one ended
+	if (hfh.file_offset == hfh.buffer_end) {
+		hfh.sequential_refill_count++;
+	} else {
+		hfh.sequential_refill_count = 0;
+	}
+
+	if (hfh.read_ahead && hfh.read_ahead->TryConsume(hfh.file_offset, length, hfh.read_buffer)) {
+		if (http_state) {
+			http_state->read_ahead_hit_count++;
+		}
+	} else {
+		if (hfh.read_ahead) {
+			// Random access, what has been read ahead will not be used
+			auto wasted_bytes = hfh.read_ahead->Cancel();
+			if (http_state) {
+				http_state->read_ahead_wasted_bytes += wasted_bytes;
+			}
+		}
+		ReadRange(hfh, hfh.file_offset, (char *)hfh.read_buffer.Ptr(), length);
+	}
+
+	hfh.buffer_available = length;
+	hfh.buffer_idx = 0;
+	hfh.buffer_start = hfh.file_offset;
+	hfh.buffer_end = hfh.buffer_start + length;
+
+	if (hfh.read_options.read_ahead_depth > 0 && hfh.sequential_refill_count >= hfh.read_options.read_ahead_trigger) {
+		if (!hfh.read_ahead) {
+			auto fetch = [this, &hfh](idx_t fetch_offset, char *fetch_buffer, idx_t fetch_length,
+			                          const Azure::Core::Context &context) {
+				ReadRange(hfh, fetch_offset, fetch_buffer, fetch_length, context);
+			};
+			hfh.read_ahead = make_uniq<AzureReadAhead>(fetch, hfh.storage_context->read_buffer_pool,
+			                                           hfh.storage_context->request_context,
+			                                           hfh.read_options.buffer_size, hfh.read_options.read_ahead_depth);
+		}
+		hfh.read_ahead->Schedule(hfh.buffer_end, hfh.length);
+	}
+}
+
+void AzureStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                       idx_t buffer_out_len) {
+	ReadRange(handle, file_offset, buffer_out, buffer_out_len, handle.storage_context->request_context);
+}
+
+void AzureStorageFileSystem::ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                       idx_t buffer_out_len, const Azure::Core::Context &context) {
+	if (buffer_out_len == 0) {
+		return;
+	}
+	// Served by the data fetched when the file was opened
+	if (handle.prefetched_data && file_offset >= handle.prefetched_start &&
+	    file_offset + buffer_out_len <= handle.prefetched_start + handle.prefetched_length) {
+		memcpy(buffer_out, handle.prefetched_data.get() + (file_offset - handle.prefetched_start), buffer_out_len);
+		if (handle.storage_context->http_state) {
+			handle.storage_context->http_state->prefetch_hit_count++;
+		}
+		return;
+	}
+	auto &storage_context = *handle.storage_context;
+	idx_t cache_size = 0;
+	if (storage_context.block_cache) {
+		cache_size = handle.read_options.block_cache_size;
+	}
+	if (storage_context.disk_cache) {
+		cache_size = MaxValue<idx_t>(cache_size, handle.read_options.disk_cache_max_size);
+	}
+	// Without ETag we cannot detect that the file changed, and we do not want a single big read to flush the cache.
+	// A read past the end of the file is left to the storage account, which reports the error
+	if (cache_size == 0 || handle.etag.empty() || buffer_out_len > cache_size ||
+	    file_offset + buffer_out_len > handle.length) {
+		FetchRange(handle, file_offset, buffer_out, buffer_out_len, context);
+		return;
+	}
+	ReadCachedRange(handle, file_offset, buffer_out, buffer_out_len, context);
+}
+
+void AzureStorageFileSystem::FetchRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                        idx_t buffer_out_len, const Azure::Core::Context &context) {
+	// The ETag is part of the key, a download of an older version of the file is never shared
+	auto key = handle.path + '\n' + handle.etag;
+	auto deduplicated = in_flight_reads.Read(key, file_offset, buffer_out_len, buffer_out, [&]() {
+		TransferRange(handle, file_offset, buffer_out, buffer_out_len, context);
+	});
+	if (deduplicated && handle.storage_context->http_state) {
+		handle.storage_context->http_state->deduplicated_read_count++;
+	}
+}
+
+void AzureStorageFileSystem::TransferRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                           idx_t buffer_out_len, const Azure::Core::Context &context) {
+	auto &storage_context = *handle.storage_context;
+	auto &adaptive_transfer = storage_context.adaptive_transfer;
+	auto &latency_tracker = storage_context.latency_tracker;
+	if (!adaptive_transfer && !latency_tracker) {
+		AzureTransferSettings transfer {handle.read_options.transfer_concurrency,
+		                                handle.read_options.transfer_chunk_size};
+		DownloadRange(handle, file_offset, buffer_out, buffer_out_len, transfer, context);
+		return;
+	}
+
+	AzureTransferSettings transfer {handle.read_options.transfer_concurrency, handle.read_options.transfer_chunk_size};
+	auto download_transfer = transfer;
+	if (adaptive_transfer) {
+		transfer = adaptive_transfer->GetSettings();
+		download_transfer = AzureAdaptiveTransfer::ForDownload(transfer, buffer_out_len);
+	}
+	auto start = std::chrono::steady_clock::now();
+	try {
+		if (latency_tracker) {
+			HedgedDownloadRange(handle, file_offset, buffer_out, buffer_out_len, download_transfer, context);
+		} else {
+			DownloadRange(handle, file_offset, buffer_out, buffer_out_len, download_transfer, context);
+		}
+	} catch (...) {
+		// Throttled or timed out requests end up here, back off
+		if (adaptive_transfer) {
+			adaptive_transfer->Record(transfer, buffer_out_len, 0, true);
+		}
+		throw;
+	}
+	auto elapsed_us =
+	    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	if (!adaptive_transfer) {
+		return;
+	}
+	adaptive_transfer->Record(transfer, buffer_out_len, elapsed_us, false);
+
+	auto &http_state = storage_context.http_state;
+	if (http_state) {
+		auto tuned_transfer = adaptive_transfer->GetSettings();
+		http_state->adaptive_concurrency = static_cast<idx_t>(tuned_transfer.concurrency);
+		http_state->adaptive_chunk_size = static_cast<idx_t>(tuned_transfer.chunk_size);
+	}
+}
+
+void AzureStorageFileSystem::HedgedDownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                                 idx_t buffer_out_len, const AzureTransferSettings &transfer,
+                                                 const Azure::Core::Context &context) {
+	auto &storage_context = *handle.storage_context;
+	auto &latency_tracker = *storage_context.latency_tracker;
+	auto &read_options = handle.read_options;
+	auto hedge_after_us = latency_tracker.GetPercentile(buffer_out_len, read_options.hedge_percentile);
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed_us = [&]() {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+	if (hedge_after_us <= 0) {
+		// Not enough samples yet to know what a slow request is
+		DownloadRange(handle, file_offset, buffer_out, buffer_out_len, transfer, context);
+		latency_tracker.Record(buffer_out_len, elapsed_us());
+		return;
+	}
+
+	// Attempt 0 is the original request, sent by this thread in the output buffer. When it is still in progress after
+	// `hedge_after_us` the timer starts attempt 1, the hedge, on its own thread and in its own buffer as the original
+	// request can still be writing when the hedge wins. The loser is cancelled, and waited for, before returning
+	// since both use the handle.
+	struct HedgeState {
+		mutex lock;
+		bool original_finished = false;
+		int winner = -1;
+		AzureReadBuffer hedge_buffer;
+		std::thread hedge;
+	};
+	HedgeState state;
+	Azure::Core::Context attempt_contexts[2] = {context.WithDeadline(Azure::DateTime::max()),
+	                                            context.WithDeadline(Azure::DateTime::max())};
+	auto send_hedge = [&]() {
+		lock_guard<mutex> guard(state.lock);
+		if (state.original_finished || !latency_tracker.TryReserveHedge(read_options.hedge_budget)) {
+			return;
+		}
+		try {
+			state.hedge_buffer = storage_context.read_buffer_pool->Allocate(buffer_out_len);
+			state.hedge = std::thread([&]() {
+				bool succeeded = true;
+				try {
+					DownloadRange(handle, file_offset, (char *)state.hedge_buffer.Ptr(), buffer_out_len, transfer,
+					              attempt_contexts[1]);
+				} catch (...) {
+					succeeded = false;
+				}
+				lock_guard<mutex> guard(state.lock);
+				if (succeeded && state.winner < 0) {
+					state.winner = 1;
+					attempt_contexts[0].Cancel();
+				}
+			});
+		} catch (...) {
+			// Out of memory or of threads: the hedge is only an optimization, it should never make a query fail
+			return;
+		}
+		if (storage_context.http_state) {
+			storage_context.http_state->hedge_issued_count++;
+		}
+	};
+	auto timer_id = hedge_timer.Schedule(start + std::chrono::microseconds(hedge_after_us), send_hedge);
+
+	std::exception_ptr original_error;
+	try {
+		DownloadRange(handle, file_offset, buffer_out, buffer_out_len, transfer, attempt_contexts[0]);
+	} catch (...) {
+		original_error = std::current_exception();
+	}
+	// Only the original requests are sampled: the duration of a read won by its hedge is not the latency of the
+	// storage account, it would lower the percentile and trigger even more hedges
+	if (!original_error) {
+		latency_tracker.Record(buffer_out_len, elapsed_us());
+	}
+	{
+		lock_guard<mutex> guard(state.lock);
+		state.original_finished = true;
+		if (!original_error && state.winner < 0) {
+			state.winner = 0;
+		}
+	}
+	hedge_timer.Cancel(timer_id);
+
+	// Stop the hedge when the original request won and wait for it, it may still succeed if the original failed
+	if (state.hedge.joinable()) {
+		{
+			lock_guard<mutex> guard(state.lock);
+			if (state.winner == 0) {
+				attempt_contexts[1].Cancel();
+			}
+		}
+		state.hedge.join();
+	}
+	if (state.winner == 1) {
+		memcpy(buffer_out, state.hedge_buffer.Ptr(), buffer_out_len);
+		if (storage_context.http_state) {
+			storage_context.http_state->hedge_won_count++;
+		}
+	}
+	storage_context.read_buffer_pool->Release(std::move(state.hedge_buffer));
+	if (state.winner < 0) {
+		std::rethrow_exception(original_error);
+	}
+}
+
+void AzureStorageFileSystem::ReadCachedRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out,
+                                             idx_t buffer_out_len, const Azure::Core::Context &context) {
+	auto &http_state = handle.storage_context->http_state;
+	auto &block_cache = handle.storage_context->block_cache;
+	auto &disk_cache = handle.storage_context->disk_cache;
+	const auto block_size = handle.read_options.block_cache_block_size;
+	const auto range_end = file_offset + buffer_out_len;
+
+	// Copy the part of the block [block_start, block_start + block_length) that overlaps the requested range
+	auto copy_block = [&](idx_t block_start, const data_t *block_data, idx_t block_length) {
+		auto copy_start = MaxValue<idx_t>(block_start, file_offset);
+		auto copy_end = MinValue<idx_t>(block_start + block_length, range_end);
+		if (copy_start < copy_end) {
+			memcpy(buffer_out + (copy_start - file_offset), block_data + (copy_start - block_start),
+			       copy_end - copy_start);
+		}
+	};
+	auto is_cached = [&](idx_t block_idx) {
+		return (block_cache && block_cache->Contains(BlockKey(handle, block_idx))) ||
+		       (disk_cache && disk_cache->Contains(DiskBlockKey(handle, block_idx)));
+	};
+
+	const auto first_block = file_offset / block_size;
+	const auto last_block = (range_end - 1) / block_size;
+	idx_t block_idx = first_block;
+	while (block_idx <= last_block) {
+		// Memory tier
+		auto block = block_cache ? block_cache->Get(BlockKey(handle, block_idx)) : nullptr;
+		if (block) {
+			if (http_state) {
+				http_state->block_cache_hit_count++;
+			}
+			copy_block(block_idx * block_size, block->Data(), block->length);
+			block_idx++;
+			continue;
+		}
+
+		// Disk tier, the block is promoted to the memory tier
+		unique_ptr<data_t[]> disk_data;
+		idx_t disk_length;
+		if (disk_cache && disk_cache->Read(DiskBlockKey(handle, block_idx), disk_data, disk_length)) {
+			if (http_state) {
+				http_state->disk_cache_hit_count++;
+			}
+			if (block_cache) {
+				block_cache->Insert(BlockKey(handle, block_idx), disk_data.get(), disk_length);
+			}
+			copy_block(block_idx * block_size, disk_data.get(), disk_length);
+			block_idx++;
+			continue;
+		}
+
+		// Download all the consecutive missing blocks with a single request
+		auto missing_end = block_idx + 1;
+		while (missing_end <= last_block && !is_cached(missing_end)) {
+			missing_end++;
+		}
+		if (http_state) {
+			http_state->block_cache_miss_count += missing_end - block_idx;
+		}
+
+		auto download_start = block_idx * block_size;
+		auto download_end = MinValue<idx_t>(missing_end * block_size, handle.length);
+		auto download_length = download_end - download_start;
+		auto download_buffer = unique_ptr<data_t[]>(new data_t[download_length]);
+		FetchRange(handle, download_start, (char *)download_buffer.get(), download_length, context);
+
+		for (; block_idx < missing_end; block_idx++) {
+			auto block_start = block_idx * block_size;
+			auto block_length = MinValue<idx_t>(block_size, download_end - block_start);
+			auto *block_data = download_buffer.get() + (block_start - download_start);
+			if (block_cache) {
+				block_cache->Insert(BlockKey(handle, block_idx), block_data, block_length);
 			}
+			if (disk_cache) {
+				disk_cache->Write(DiskBlockKey(handle, block_idx), block_data, block_length);
+			}
+			copy_block(block_start, block_data, block_length);
 		}
 	}
 }
 
+std::string AzureStorageFileSystem::BlockKey(const AzureFileHandle &handle, idx_t block_idx) {
+	return AzureBlockCache::BlockKey(handle.path, handle.etag, handle.read_options.block_cache_block_size, block_idx);
+}
+
+std::string AzureStorageFileSystem::DiskBlockKey(const AzureFileHandle &handle, idx_t block_idx) {
+	return BlockKey(handle, block_idx) + '\n' + std::to_string(handle.last_modified);
+}
+
 int64_t AzureStorageFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	auto &hfh = handle.Cast<AzureFileHandle>();
+	if (hfh.file_info_pending) {
+		// The range of the GET is truncated at the end of the file
+		auto read_length = ReadWithPendingFileInfo(hfh, (char *)buffer, nr_bytes, hfh.file_offset);
+		if (read_length > 0) {
+			hfh.file_offset += read_length;
+			return read_length;
+		}
+	}
 	idx_t max_read = hfh.length - hfh.file_offset;
 	nr_bytes = MinValue<idx_t>(max_read, nr_bytes);
 	Read(handle, buffer, nr_bytes, hfh.file_offset);
@@ -181,15 +1018,88 @@ shared_ptr<AzureContextState> AzureStorageFileSystem::GetOrCreateStorageContext(
 		result = registered_state->Get<AzureContextState>(context_key);
 		if (!result || !result->IsValid()) {
 			result = CreateStorageContext(opener, path, parsed_url);
+			InitializeStorageContext(opener, *result, parsed_url);
 			registered_state->Insert(context_key, result);
 		}
 	} else {
 		result = CreateStorageContext(opener, path, parsed_url);
+		InitializeStorageContext(opener, *result, parsed_url);
 	}
 
 	return result;
 }
 
+void AzureStorageFileSystem::InitializeStorageContext(optional_ptr<FileOpener> opener,
+                                                      AzureContextState &storage_context,
+                                                      const AzureParsedUrl &parsed_url) {
+	auto client_context = FileOpener::TryGetClientContext(opener);
+	if (!client_context) {
+		return;
+	}
+	storage_context.metadata_prefetcher = &metadata_prefetcher;
+
+	// The read buffers count against the memory limit of the database
+	storage_context.read_buffer_pool =
+	    make_shared_ptr<AzureReadBufferPool>(&BufferManager::GetBufferManager(*client_context));
+
+	// Database wide timings of the requests, per storage account
+	storage_context.request_context = HttpStatePolicy::AttachRequestMetrics(
+	    storage_context.request_context, AzureRequestMetrics::GetMetrics(*client_context));
+
+	Value request_log_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_request_log_size", request_log_size_val) &&
+	    request_log_size_val.GetValue<idx_t>() > 0) {
+		auto request_log = AzureRequestLog::GetLog(*client_context)->GetBuffer(request_log_size_val.GetValue<idx_t>());
+		storage_context.request_context =
+		    HttpStatePolicy::AttachRequestLog(storage_context.request_context, std::move(request_log));
+	}
+
+	Value not_found_cache_ttl_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_not_found_cache_ttl", not_found_cache_ttl_val) &&
+	    not_found_cache_ttl_val.GetValue<idx_t>() > 0) {
+		storage_context.not_found_cache = AzureNotFoundCache::GetCache(*client_context);
+		storage_context.not_found_cache->SetTTL(not_found_cache_ttl_val.GetValue<idx_t>());
+	}
+
+	if (storage_context.read_options.block_cache_size > 0) {
+		storage_context.block_cache = AzureBlockCache::GetCache(*client_context);
+		storage_context.block_cache->SetCapacity(storage_context.read_options.block_cache_size);
+	}
+
+	auto &read_options = storage_context.read_options;
+	if (!read_options.disk_cache_directory.empty() && read_options.disk_cache_max_size > 0) {
+		storage_context.disk_cache = AzureDiskCache::GetCache(*client_context);
+		storage_context.disk_cache->Configure(read_options.disk_cache_directory, read_options.disk_cache_max_size,
+		                                      read_options.disk_cache_eviction);
+	}
+
+	Value max_in_flight_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_account_max_in_flight", max_in_flight_val) &&
+	    max_in_flight_val.GetValue<idx_t>() > 0) {
+		double max_request_rate = 0;
+		Value max_request_rate_val;
+		if (FileOpener::TryGetCurrentSetting(opener, "azure_account_max_request_rate", max_request_rate_val)) {
+			max_request_rate = max_request_rate_val.GetValue<double>();
+		}
+		auto governors = AzureAccountGovernors::GetGovernors(*client_context);
+		governors->Configure(max_in_flight_val.GetValue<idx_t>(), max_request_rate);
+		storage_context.request_context =
+		    AzureThrottlingPolicy::AttachGovernors(storage_context.request_context, std::move(governors));
+	}
+
+	if (read_options.hedge_percentile > 0) {
+		storage_context.latency_tracker = AzureLatencyTrackerRegistry::GetRegistry(*client_context)
+		                                      ->GetAccount(GetContextPrefix() + parsed_url.storage_account_name);
+	}
+
+	if (read_options.adaptive_transfer) {
+		AzureTransferSettings initial_settings {read_options.transfer_concurrency, read_options.transfer_chunk_size};
+		storage_context.adaptive_transfer = AzureAdaptiveTransferRegistry::GetRegistry(*client_context)
+		                                        ->GetAccount(GetContextPrefix() + parsed_url.storage_account_name,
+		                                                     initial_settings);
+	}
+}
+
 AzureReadOptions AzureStorageFileSystem::ParseAzureReadOptions(optional_ptr<FileOpener> opener) {
 	AzureReadOptions options;
 
@@ -208,9 +1118,126 @@ AzureReadOptions AzureStorageFileSystem::ParseAzureReadOptions(optional_ptr<File
 		options.buffer_size = buffer_size_val.GetValue<idx_t>();
 	}
 
+	Value read_ahead_depth_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_ahead_depth", read_ahead_depth_val)) {
+		options.read_ahead_depth = read_ahead_depth_val.GetValue<idx_t>();
+	}
+
+	Value read_ahead_trigger_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_ahead_trigger", read_ahead_trigger_val)) {
+		options.read_ahead_trigger = read_ahead_trigger_val.GetValue<idx_t>();
+	}
+
+	Value block_cache_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_block_cache_size", block_cache_size_val)) {
+		options.block_cache_size = block_cache_size_val.GetValue<idx_t>();
+	}
+
+	Value small_file_threshold_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_small_file_threshold", small_file_threshold_val)) {
+		options.small_file_threshold = small_file_threshold_val.GetValue<idx_t>();
+	}
+
+	Value tail_prefetch_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_tail_prefetch_size", tail_prefetch_size_val)) {
+		options.tail_prefetch_size = tail_prefetch_size_val.GetValue<idx_t>();
+	}
+
+	Value lazy_open_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_lazy_open", lazy_open_val)) {
+		options.lazy_open = lazy_open_val.GetValue<bool>();
+	}
+
+	Value adaptive_transfer_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_adaptive_transfer", adaptive_transfer_val)) {
+		options.adaptive_transfer = adaptive_transfer_val.GetValue<bool>();
+	}
+
+	Value hedge_percentile_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_hedge_percentile", hedge_percentile_val)) {
+		options.hedge_percentile = hedge_percentile_val.GetValue<double>();
+	}
+
+	Value hedge_budget_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_hedge_budget", hedge_budget_val)) {
+		options.hedge_budget = hedge_budget_val.GetValue<double>();
+	}
+
+	Value coalesce_gap_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_read_coalesce_gap", coalesce_gap_val)) {
+		options.coalesce_gap = coalesce_gap_val.GetValue<idx_t>();
+	}
+
+	Value block_cache_block_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_block_cache_block_size", block_cache_block_size_val)) {
+		options.block_cache_block_size = block_cache_block_size_val.GetValue<idx_t>();
+		if (options.block_cache_block_size == 0) {
+			throw InvalidInputException("azure_block_cache_block_size must be greater than 0");
+		}
+	}
+
+	Value disk_cache_directory_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_disk_cache_directory", disk_cache_directory_val) &&
+	    !disk_cache_directory_val.IsNull()) {
+		options.disk_cache_directory = disk_cache_directory_val.ToString();
+	}
+
+	Value disk_cache_max_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_disk_cache_max_size", disk_cache_max_size_val)) {
+		options.disk_cache_max_size = disk_cache_max_size_val.GetValue<idx_t>();
+	}
+
+	Value disk_cache_eviction_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_disk_cache_eviction", disk_cache_eviction_val) &&
+	    !disk_cache_eviction_val.IsNull()) {
+		options.disk_cache_eviction = AzureDiskCache::ParseEviction(disk_cache_eviction_val.ToString());
+	}
+
 	return options;
 }
 
+AzureWriteOptions AzureStorageFileSystem::ParseAzureWriteOptions(optional_ptr<FileOpener> opener) {
+	AzureWriteOptions options;
+
+	Value block_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_write_block_size", block_size_val)) {
+		options.block_size = block_size_val.GetValue<idx_t>();
+		if (options.block_size == 0) {
+			throw InvalidInputException("azure_write_block_size must be greater than 0");
+		}
+	}
+
+	Value upload_concurrency_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_write_upload_concurrency", upload_concurrency_val)) {
+		options.upload_concurrency = upload_concurrency_val.GetValue<idx_t>();
+	}
+
+	return options;
+}
+
+shared_ptr<AzureHTTPState> AzureStorageFileSystem::GetHttpState(optional_ptr<FileOpener> opener) {
+	Value value;
+	bool enable_http_stats = false;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_http_stats", value)) {
+		enable_http_stats = value.GetValue<bool>();
+	}
+
+	shared_ptr<AzureHTTPState> http_state;
+	if (enable_http_stats) {
+		http_state = AzureHTTPState::TryGetState(opener);
+	}
+
+	return http_state;
+}
+
+idx_t AzureStorageFileSystem::GetListConcurrency(optional_ptr<FileOpener> opener) {
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_list_concurrency", value)) {
+		return MaxValue<idx_t>(value.GetValue<idx_t>(), 1);
+	}
+	return 1;
+}
+
 time_t AzureStorageFileSystem::ToTimeT(const Azure::DateTime &dt) {
 	auto time_point = static_cast<std::chrono::system_clock::time_point>(dt);
 	return std::chrono::system_clock::to_time_t(time_point);
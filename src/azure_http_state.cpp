@@ -11,6 +11,29 @@ void AzureHTTPState::Reset() {
 	post_count = 0;
 	total_bytes_received = 0;
 	total_bytes_sent = 0;
+	list_count = 0;
+	list_time_us = 0;
+	read_ahead_hit_count = 0;
+	read_ahead_wasted_bytes = 0;
+	read_buffer_copy_bytes = 0;
+	prefetch_hit_count = 0;
+	coalesced_read_count = 0;
+	deduplicated_read_count = 0;
+	not_found_cache_hit_count = 0;
+	exists_from_listing_count = 0;
+	metadata_prefetch_count = 0;
+	block_cache_hit_count = 0;
+	disk_cache_hit_count = 0;
+	block_cache_miss_count = 0;
+	throttled_count = 0;
+	throttle_wait_us = 0;
+	hedge_issued_count = 0;
+	hedge_won_count = 0;
+	adaptive_concurrency = 0;
+	adaptive_chunk_size = 0;
+	for (auto &histograms : method_histograms) {
+		histograms.Reset();
+	}
 }
 
 shared_ptr<AzureHTTPState> AzureHTTPState::TryGetState(ClientContext &context) {
@@ -25,6 +48,24 @@ shared_ptr<AzureHTTPState> AzureHTTPState::TryGetState(optional_ptr<FileOpener>
 	return nullptr;
 }
 
+//! Microseconds as milliseconds, with a decimal below 10ms
+static string FormatMilliseconds(idx_t us) {
+	if (us < 10000) {
+		return to_string(us / 1000) + "." + to_string(us / 100 % 10);
+	}
+	return to_string(us / 1000);
+}
+
+//! p50/p90/p99/max of a histogram
+static string FormatPercentiles(const AzureHistogram &histogram, string (*format)(idx_t)) {
+	return format(histogram.Percentile(0.5)) + "/" + format(histogram.Percentile(0.9)) + "/" +
+	       format(histogram.Percentile(0.99)) + "/" + format(histogram.Max());
+}
+
+static string FormatMebibytes(idx_t bytes) {
+	return to_string(bytes / (1024 * 1024));
+}
+
 void AzureHTTPState::WriteProfilingInformation(std::ostream &ss) {
 	string read = "in: " + StringUtil::BytesToHumanReadableString(total_bytes_received);
 	string written = "out: " + StringUtil::BytesToHumanReadableString(total_bytes_sent);
@@ -44,6 +85,88 @@ void AzureHTTPState::WriteProfilingInformation(std::ostream &ss) {
 	ss << "││" + QueryProfiler::DrawPadded(get, TOTAL_BOX_WIDTH - 4) + "││\n";
 	ss << "││" + QueryProfiler::DrawPadded(put, TOTAL_BOX_WIDTH - 4) + "││\n";
 	ss << "││" + QueryProfiler::DrawPadded(post, TOTAL_BOX_WIDTH - 4) + "││\n";
+	if (list_count != 0) {
+		string list = "#list: " + to_string(list_count);
+		string list_time = "list time: " + to_string(list_time_us / 1000) + "ms";
+		ss << "││" + QueryProfiler::DrawPadded(list, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(list_time, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (read_ahead_hit_count != 0 || read_ahead_wasted_bytes != 0) {
+		string read_ahead_hit = "#read-ahead hit: " + to_string(read_ahead_hit_count);
+		string read_ahead_wasted =
+		    "read-ahead wasted: " + StringUtil::BytesToHumanReadableString(read_ahead_wasted_bytes);
+		ss << "││" + QueryProfiler::DrawPadded(read_ahead_hit, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(read_ahead_wasted, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (read_buffer_copy_bytes != 0) {
+		string copied = "read buffer copied: " + StringUtil::BytesToHumanReadableString(read_buffer_copy_bytes);
+		ss << "││" + QueryProfiler::DrawPadded(copied, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (prefetch_hit_count != 0) {
+		string prefetch_hit = "#prefetch hit: " + to_string(prefetch_hit_count);
+		ss << "││" + QueryProfiler::DrawPadded(prefetch_hit, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (coalesced_read_count != 0) {
+		string coalesced_read = "#coalesced read: " + to_string(coalesced_read_count);
+		ss << "││" + QueryProfiler::DrawPadded(coalesced_read, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (deduplicated_read_count != 0) {
+		string deduplicated_read = "#dedup read: " + to_string(deduplicated_read_count);
+		ss << "││" + QueryProfiler::DrawPadded(deduplicated_read, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (not_found_cache_hit_count != 0 || exists_from_listing_count != 0) {
+		string not_found_hit = "#not found cache hit: " + to_string(not_found_cache_hit_count);
+		string exists_listed = "#exists from listing: " + to_string(exists_from_listing_count);
+		ss << "││" + QueryProfiler::DrawPadded(not_found_hit, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(exists_listed, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (metadata_prefetch_count != 0) {
+		string metadata_prefetch = "#metadata prefetch: " + to_string(metadata_prefetch_count);
+		ss << "││" + QueryProfiler::DrawPadded(metadata_prefetch, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (block_cache_hit_count != 0 || disk_cache_hit_count != 0 || block_cache_miss_count != 0) {
+		string block_cache_hit = "#block cache hit: " + to_string(block_cache_hit_count);
+		string disk_cache_hit = "#disk cache hit: " + to_string(disk_cache_hit_count);
+		string block_cache_miss = "#block cache miss: " + to_string(block_cache_miss_count);
+		ss << "││" + QueryProfiler::DrawPadded(block_cache_hit, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(disk_cache_hit, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(block_cache_miss, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (throttled_count != 0 || throttle_wait_us != 0) {
+		string throttled = "#throttled: " + to_string(throttled_count);
+		string throttle_wait = "throttle wait: " + to_string(throttle_wait_us / 1000) + "ms";
+		ss << "││" + QueryProfiler::DrawPadded(throttled, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(throttle_wait, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (hedge_issued_count != 0) {
+		string hedge_issued = "#hedge issued: " + to_string(hedge_issued_count);
+		string hedge_won = "#hedge won: " + to_string(hedge_won_count);
+		ss << "││" + QueryProfiler::DrawPadded(hedge_issued, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(hedge_won, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	if (adaptive_concurrency != 0) {
+		string concurrency = "adaptive concurrency: " + to_string(adaptive_concurrency);
+		string chunk_size = "adaptive chunk: " + StringUtil::BytesToHumanReadableString(adaptive_chunk_size);
+		ss << "││" + QueryProfiler::DrawPadded(concurrency, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(chunk_size, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	for (idx_t method_idx = 0; method_idx < AZURE_REQUEST_METHOD_COUNT; method_idx++) {
+		auto &histograms = method_histograms[method_idx];
+		if (histograms.latency_us.Count() == 0) {
+			continue;
+		}
+		string method = string(AzureRequestMethodToString(static_cast<AzureRequestMethod>(method_idx))) +
+		                " p50/p90/p99/max";
+		string latency = "  latency: " + FormatPercentiles(histograms.latency_us, FormatMilliseconds) + "ms";
+		string ttfb = "  ttfb: " + FormatPercentiles(histograms.ttfb_us, FormatMilliseconds) + "ms";
+		ss << "││" + QueryProfiler::DrawPadded(method, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(latency, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(ttfb, TOTAL_BOX_WIDTH - 4) + "││\n";
+		if (histograms.throughput.Count() != 0) {
+			string throughput = "  tput: " + FormatPercentiles(histograms.throughput, FormatMebibytes) + "MiB/s";
+			ss << "││" + QueryProfiler::DrawPadded(throughput, TOTAL_BOX_WIDTH - 4) + "││\n";
+		}
+	}
 	ss << "│└───────────────────────────────────┘│\n";
 	ss << "└─────────────────────────────────────┘\n";
 }
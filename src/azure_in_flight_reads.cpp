@@ -0,0 +1,92 @@
+#include "azure_in_flight_reads.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+bool AzureInFlightReads::TryReadFromFetch(std::unique_lock<mutex> &guard, const std::string &key, idx_t offset,
+                                          idx_t length, char *buffer_out) {
+	auto entry = fetches.find(key);
+	if (entry == fetches.end()) {
+		return false;
+	}
+	shared_ptr<Fetch> fetch;
+	for (auto &candidate : entry->second) {
+		if (offset >= candidate->offset && offset + length <= candidate->offset + candidate->length) {
+			fetch = candidate;
+			break;
+		}
+	}
+	if (!fetch) {
+		return false;
+	}
+
+	fetch->waiter_count++;
+	fetch_changed.wait(guard, [&]() { return fetch->finished; });
+	bool copied = false;
+	if (!fetch->failed) {
+		// The download keeps its buffer until the waiters are done, no need to hold the lock while copying
+		guard.unlock();
+		memcpy(buffer_out, fetch->data + (offset - fetch->offset), length);
+		guard.lock();
+		copied = true;
+	}
+	fetch->waiter_count--;
+	fetch_changed.notify_all();
+	return copied;
+}
+
+bool AzureInFlightReads::Read(const std::string &key, idx_t offset, idx_t length, char *buffer_out,
+                              const std::function<void()> &fetch_function) {
+	std::unique_lock<mutex> guard(lock);
+	if (TryReadFromFetch(guard, key, offset, length, buffer_out)) {
+		return true;
+	}
+
+	// Download the range ourselves, the next identical reads will wait for it. When the download we waited for
+	// failed, ours is not shared: the waiters of the failed download retry on their own as well.
+	auto fetch = make_shared_ptr<Fetch>();
+	fetch->offset = offset;
+	fetch->length = length;
+	fetch->data = buffer_out;
+	auto &file_fetches = fetches[key];
+	file_fetches.push_back(fetch);
+	guard.unlock();
+
+	std::exception_ptr error;
+	try {
+		fetch_function();
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	guard.lock();
+	fetch->finished = true;
+	fetch->failed = error != nullptr;
+	fetch_changed.notify_all();
+	fetch_changed.wait(guard, [&]() { return fetch->waiter_count == 0; });
+	auto entry = fetches.find(key);
+	entry->second.erase(std::find(entry->second.begin(), entry->second.end(), fetch));
+	if (entry->second.empty()) {
+		fetches.erase(entry);
+	}
+	guard.unlock();
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	return false;
+}
+
+idx_t AzureInFlightReads::GetWaitingReadCount() {
+	lock_guard<mutex> guard(lock);
+	idx_t count = 0;
+	for (auto &entry : fetches) {
+		for (auto &fetch : entry.second) {
+			count += fetch->waiter_count;
+		}
+	}
+	return count;
+}
+
+} // namespace duckdb
@@ -0,0 +1,85 @@
+#include "azure_latency_tracker.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace duckdb {
+
+//! Ranges up to 64KiB are in the first size class, each next class doubles the size
+static constexpr idx_t SMALLEST_CLASS_SIZE = 64 * 1024;
+static constexpr idx_t SIZE_CLASS_COUNT = 12;
+
+constexpr idx_t AzureLatencyTracker::SAMPLES_PER_CLASS;
+constexpr idx_t AzureLatencyTracker::MIN_SAMPLES;
+
+AzureLatencyTracker::AzureLatencyTracker() : size_classes(SIZE_CLASS_COUNT), request_count(0), hedge_count(0) {
+}
+
+idx_t AzureLatencyTracker::SizeClass(idx_t bytes) {
+	idx_t size_class = 0;
+	idx_t class_size = SMALLEST_CLASS_SIZE;
+	while (bytes > class_size && size_class + 1 < SIZE_CLASS_COUNT) {
+		class_size *= 2;
+		size_class++;
+	}
+	return size_class;
+}
+
+void AzureLatencyTracker::Record(idx_t bytes, int64_t latency_us) {
+	lock_guard<mutex> guard(lock);
+	request_count++;
+	auto &samples = size_classes[SizeClass(bytes)];
+	if (samples.latencies.size() < SAMPLES_PER_CLASS) {
+		samples.latencies.push_back(latency_us);
+	} else {
+		samples.latencies[samples.next] = latency_us;
+		samples.next = (samples.next + 1) % SAMPLES_PER_CLASS;
+	}
+}
+
+int64_t AzureLatencyTracker::GetPercentile(idx_t bytes, double percentile) {
+	vector<int64_t> latencies;
+	{
+		lock_guard<mutex> guard(lock);
+		latencies = size_classes[SizeClass(bytes)].latencies;
+	}
+	if (latencies.size() < MIN_SAMPLES) {
+		return 0;
+	}
+	auto rank = static_cast<idx_t>(std::ceil(percentile * static_cast<double>(latencies.size())));
+	rank = MinValue<idx_t>(MaxValue<idx_t>(rank, 1), latencies.size()) - 1;
+	std::nth_element(latencies.begin(), latencies.begin() + static_cast<int64_t>(rank), latencies.end());
+	return latencies[rank];
+}
+
+bool AzureLatencyTracker::TryReserveHedge(double budget) {
+	lock_guard<mutex> guard(lock);
+	if (static_cast<double>(hedge_count + 1) > budget * static_cast<double>(request_count)) {
+		return false;
+	}
+	hedge_count++;
+	return true;
+}
+
+shared_ptr<AzureLatencyTrackerRegistry> AzureLatencyTrackerRegistry::GetRegistry(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureLatencyTrackerRegistry>(ObjectType());
+}
+
+shared_ptr<AzureLatencyTracker> AzureLatencyTrackerRegistry::GetAccount(const std::string &account) {
+	lock_guard<mutex> guard(lock);
+	auto &entry = accounts[account];
+	if (!entry) {
+		entry = make_shared_ptr<AzureLatencyTracker>();
+	}
+	return entry;
+}
+
+string AzureLatencyTrackerRegistry::ObjectType() {
+	return "azure_latency_tracker";
+}
+
+string AzureLatencyTrackerRegistry::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -0,0 +1,108 @@
+#include "azure_metadata_prefetcher.hpp"
+#include "duckdb/common/helper.hpp"
+#include <chrono>
+
+namespace duckdb {
+
+constexpr idx_t AzureMetadataPrefetcher::IDLE_TIMEOUT_MS;
+
+AzureMetadataPrefetcher::AzureMetadataPrefetcher(fetch_function_t fetch_p)
+    : fetch(std::move(fetch_p)), next_worker_id(0), shutdown(false) {
+}
+
+AzureMetadataPrefetcher::~AzureMetadataPrefetcher() {
+	unordered_map<idx_t, std::thread> remaining_workers;
+	{
+		lock_guard<mutex> guard(lock);
+		shutdown = true;
+		tasks.clear();
+		remaining_workers = std::move(workers);
+	}
+	task_available.notify_all();
+	for (auto &worker : remaining_workers) {
+		worker.second.join();
+	}
+}
+
+void AzureMetadataPrefetcher::Schedule(const shared_ptr<AzureContextState> &storage_context,
+                                       const vector<std::string> &paths, idx_t concurrency) {
+	{
+		lock_guard<mutex> guard(lock);
+		for (const auto &path : paths) {
+			if (unfinished.emplace(storage_context.get(), path).second) {
+				tasks.push_back(Task {storage_context, path});
+			}
+		}
+		JoinExitedWorkers();
+		auto worker_count = MinValue<idx_t>(concurrency, tasks.size());
+		while (workers.size() < worker_count) {
+			auto worker_id = next_worker_id++;
+			workers[worker_id] = std::thread([this, worker_id]() { Work(worker_id); });
+		}
+	}
+	task_available.notify_all();
+}
+
+void AzureMetadataPrefetcher::Wait(const AzureContextState &storage_context, const std::string &path) {
+	std::unique_lock<mutex> guard(lock);
+	file_key_t key(&storage_context, path);
+	task_finished.wait(guard, [&]() { return unfinished.find(key) == unfinished.end(); });
+}
+
+void AzureMetadataPrefetcher::Cancel(const AzureContextState &storage_context) {
+	{
+		lock_guard<mutex> guard(lock);
+		for (auto task = tasks.begin(); task != tasks.end();) {
+			if (task->storage_context.get() != &storage_context) {
+				task++;
+				continue;
+			}
+			unfinished.erase(file_key_t(&storage_context, task->path));
+			task = tasks.erase(task);
+		}
+	}
+	task_finished.notify_all();
+}
+
+void AzureMetadataPrefetcher::JoinExitedWorkers() {
+	for (auto worker_id : exited_workers) {
+		auto worker = workers.find(worker_id);
+		// It does not use the lock anymore, the join cannot block on us
+		worker->second.join();
+		workers.erase(worker);
+	}
+	exited_workers.clear();
+}
+
+void AzureMetadataPrefetcher::Work(idx_t worker_id) {
+	std::unique_lock<mutex> guard(lock);
+	while (true) {
+		auto has_task = task_available.wait_for(guard, std::chrono::milliseconds(IDLE_TIMEOUT_MS),
+		                                        [this]() { return shutdown || !tasks.empty(); });
+		if (shutdown) {
+			return;
+		}
+		if (!has_task) {
+			// Joined by the next Schedule, or by the destructor
+			exited_workers.push_back(worker_id);
+			return;
+		}
+
+		{
+			// The task is dropped before waiting again, it must not keep its storage context alive
+			auto task = std::move(tasks.front());
+			tasks.pop_front();
+			guard.unlock();
+			try {
+				fetch(*task.storage_context, task.path);
+			} catch (...) {
+				// Opening the file sends its own request and reports the error
+			}
+			guard.lock();
+			unfinished.erase(file_key_t(task.storage_context.get(), task.path));
+		}
+		task_finished.notify_all();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,77 @@
+#include "azure_not_found_cache.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+constexpr idx_t AzureNotFoundCache::MAX_ENTRIES;
+
+AzureNotFoundCache::AzureNotFoundCache() : ttl(0) {
+}
+
+shared_ptr<AzureNotFoundCache> AzureNotFoundCache::GetCache(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureNotFoundCache>(ObjectType());
+}
+
+void AzureNotFoundCache::SetTTL(idx_t ttl_ms) {
+	lock_guard<mutex> guard(lock);
+	ttl = std::chrono::milliseconds(ttl_ms);
+}
+
+bool AzureNotFoundCache::Contains(const std::string &path) {
+	lock_guard<mutex> guard(lock);
+	auto entry = expirations.find(path);
+	if (entry == expirations.end()) {
+		miss_count++;
+		return false;
+	}
+	if (entry->second <= std::chrono::steady_clock::now()) {
+		expirations.erase(entry);
+		miss_count++;
+		return false;
+	}
+	hit_count++;
+	return true;
+}
+
+void AzureNotFoundCache::Add(const std::string &path) {
+	lock_guard<mutex> guard(lock);
+	auto now = std::chrono::steady_clock::now();
+	if (expirations.size() >= MAX_ENTRIES) {
+		for (auto it = expirations.begin(); it != expirations.end();) {
+			if (it->second <= now) {
+				it = expirations.erase(it);
+			} else {
+				it++;
+			}
+		}
+		if (expirations.size() >= MAX_ENTRIES) {
+			expirations.clear();
+		}
+	}
+	expirations[path] = now + ttl;
+}
+
+void AzureNotFoundCache::Remove(const std::string &path) {
+	lock_guard<mutex> guard(lock);
+	expirations.erase(path);
+}
+
+void AzureNotFoundCache::Clear() {
+	lock_guard<mutex> guard(lock);
+	expirations.clear();
+}
+
+idx_t AzureNotFoundCache::GetEntryCount() {
+	lock_guard<mutex> guard(lock);
+	return expirations.size();
+}
+
+string AzureNotFoundCache::ObjectType() {
+	return "azure_not_found_cache";
+}
+
+string AzureNotFoundCache::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
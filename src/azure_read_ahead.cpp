@@ -0,0 +1,126 @@
+#include "azure_read_ahead.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+constexpr idx_t AzureReadAhead::MAX_WORKERS;
+
+AzureReadAhead::AzureReadAhead(fetch_function_t fetch_p, shared_ptr<AzureReadBufferPool> pool_p,
+                               Azure::Core::Context context_p, idx_t buffer_size, idx_t depth)
+    : fetch(std::move(fetch_p)), pool(std::move(pool_p)), context(std::move(context_p)), buffer_size(buffer_size),
+      depth(depth), shutdown(false) {
+}
+
+AzureReadAhead::~AzureReadAhead() {
+	Cancel();
+	{
+		lock_guard<mutex> guard(lock);
+		shutdown = true;
+	}
+	buffer_changed.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+void AzureReadAhead::Schedule(idx_t offset, idx_t file_length) {
+	{
+		lock_guard<mutex> guard(lock);
+		auto next_offset = buffers.empty() ? offset : buffers.back()->offset + buffers.back()->length;
+		while (buffers.size() < depth && next_offset < file_length) {
+			auto buffer = make_shared_ptr<ReadAheadBuffer>();
+			buffer->offset = next_offset;
+			buffer->length = MinValue<idx_t>(buffer_size, file_length - next_offset);
+			// Always allocate a full buffer, it will be swapped with the handle read buffer
+			buffer->data = pool->Allocate(buffer_size);
+			// A child context, cancelling it only stops this download
+			buffer->context = context.WithDeadline(Azure::DateTime::max());
+
+			next_offset += buffer->length;
+			buffers.push_back(buffer);
+			pending.push_back(std::move(buffer));
+		}
+		// The workers are started on demand and kept until the read-ahead is destroyed
+		auto worker_count = MinValue<idx_t>(MinValue<idx_t>(depth, MAX_WORKERS), pending.size());
+		while (workers.size() < worker_count) {
+			workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+	buffer_changed.notify_all();
+}
+
+void AzureReadAhead::WorkerLoop() {
+	std::unique_lock<mutex> guard(lock);
+	while (true) {
+		buffer_changed.wait(guard, [this]() { return shutdown || !pending.empty(); });
+		if (shutdown) {
+			return;
+		}
+		auto buffer = std::move(pending.front());
+		pending.pop_front();
+		buffer->started = true;
+		guard.unlock();
+
+		// The buffer is not touched by the reader until it is finished
+		std::exception_ptr error;
+		try {
+			fetch(buffer->offset, (char *)buffer->data.Ptr(), buffer->length, buffer->context);
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		guard.lock();
+		buffer->error = std::move(error);
+		buffer->finished = true;
+		buffer_changed.notify_all();
+	}
+}
+
+bool AzureReadAhead::TryConsume(idx_t offset, idx_t length, AzureReadBuffer &buffer) {
+	shared_ptr<ReadAheadBuffer> front;
+	{
+		std::unique_lock<mutex> guard(lock);
+		if (buffers.empty() || buffers.front()->offset != offset || buffers.front()->length != length) {
+			return false;
+		}
+		front = std::move(buffers.front());
+		buffers.pop_front();
+		// It is the oldest buffer, the next free worker picks it if it is still pending
+		buffer_changed.wait(guard, [&]() { return front->finished; });
+	}
+
+	// Re-throw the download error if there is one
+	if (front->error) {
+		pool->Release(std::move(front->data));
+		std::rethrow_exception(front->error);
+	}
+	std::swap(buffer, front->data);
+	pool->Release(std::move(front->data));
+	return true;
+}
+
+idx_t AzureReadAhead::Cancel() {
+	idx_t wasted_bytes = 0;
+	std::unique_lock<mutex> guard(lock);
+	// The pending buffers are never downloaded, the ones in flight are stopped
+	pending.clear();
+	for (auto &buffer : buffers) {
+		if (buffer->started && !buffer->finished) {
+			buffer->context.Cancel();
+		}
+	}
+	for (auto &buffer : buffers) {
+		if (!buffer->started) {
+			pool->Release(std::move(buffer->data));
+			continue;
+		}
+		// The buffer memory is still used by the download until it notices the cancellation
+		buffer_changed.wait(guard, [&]() { return buffer->finished; });
+		wasted_bytes += buffer->length;
+		pool->Release(std::move(buffer->data));
+	}
+	buffers.clear();
+	return wasted_bytes;
+}
+
+} // namespace duckdb
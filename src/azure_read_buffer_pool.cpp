@@ -0,0 +1,76 @@
+#include "azure_read_buffer_pool.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+constexpr idx_t AzureReadBufferPool::MAX_IDLE_BUFFERS;
+
+//////// AzureReadBuffer ////////
+AzureReadBuffer::AzureReadBuffer() : ptr(nullptr), size(0) {
+}
+
+AzureReadBuffer::AzureReadBuffer(BufferHandle handle_p, idx_t size)
+    : handle(std::move(handle_p)), ptr(handle.Ptr()), size(size) {
+}
+
+AzureReadBuffer::AzureReadBuffer(unique_ptr<data_t[]> data_p, idx_t size)
+    : data(std::move(data_p)), ptr(data.get()), size(size) {
+}
+
+AzureReadBuffer::AzureReadBuffer(AzureReadBuffer &&other) noexcept
+    : handle(std::move(other.handle)), data(std::move(other.data)), ptr(other.ptr), size(other.size) {
+	other.ptr = nullptr;
+	other.size = 0;
+}
+
+AzureReadBuffer &AzureReadBuffer::operator=(AzureReadBuffer &&other) noexcept {
+	std::swap(handle, other.handle);
+	std::swap(data, other.data);
+	std::swap(ptr, other.ptr);
+	std::swap(size, other.size);
+	return *this;
+}
+
+//////// AzureReadBufferPool ////////
+AzureReadBufferPool::AzureReadBufferPool(optional_ptr<BufferManager> buffer_manager)
+    : buffer_manager(buffer_manager), closed(false) {
+}
+
+AzureReadBuffer AzureReadBufferPool::Allocate(idx_t size) {
+	{
+		lock_guard<mutex> guard(lock);
+		for (auto it = idle_buffers.begin(); it != idle_buffers.end(); it++) {
+			if (it->Size() == size) {
+				auto buffer = std::move(*it);
+				idle_buffers.erase(it);
+				return buffer;
+			}
+		}
+	}
+	if (!buffer_manager) {
+		return AzureReadBuffer(unique_ptr<data_t[]>(new data_t[size]), size);
+	}
+	// Throws when the memory limit is reached, like the other allocations of the query
+	return AzureReadBuffer(buffer_manager->Allocate(MemoryTag::EXTENSION, size), size);
+}
+
+void AzureReadBufferPool::Release(AzureReadBuffer buffer) {
+	if (!buffer) {
+		return;
+	}
+	lock_guard<mutex> guard(lock);
+	if (!closed && idle_buffers.size() < MAX_IDLE_BUFFERS) {
+		idle_buffers.push_back(std::move(buffer));
+	}
+}
+
+void AzureReadBufferPool::Close() {
+	vector<AzureReadBuffer> freed_buffers;
+	{
+		lock_guard<mutex> guard(lock);
+		closed = true;
+		std::swap(freed_buffers, idle_buffers);
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,111 @@
+#include "azure_request_log.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace duckdb {
+
+constexpr idx_t AzureRequestLogEntry::MAX_HOST_LENGTH;
+constexpr idx_t AzureRequestLogEntry::MAX_PATH_LENGTH;
+constexpr idx_t AzureRequestLogEntry::MAX_RANGE_LENGTH;
+constexpr idx_t AzureRequestLogBuffer::SLOT_BUSY;
+
+//////// AzureRequestLogEntry ////////
+static void CopyTruncated(char *target, idx_t target_size, const std::string &value) {
+	auto length = MinValue<idx_t>(value.size(), target_size - 1);
+	memcpy(target, value.data(), length);
+	target[length] = '\0';
+}
+
+void AzureRequestLogEntry::SetHost(const std::string &value) {
+	CopyTruncated(host, MAX_HOST_LENGTH, value);
+}
+
+void AzureRequestLogEntry::SetPath(const std::string &value) {
+	CopyTruncated(path, MAX_PATH_LENGTH, value);
+}
+
+void AzureRequestLogEntry::SetRange(const std::string &value) {
+	CopyTruncated(range, MAX_RANGE_LENGTH, value);
+}
+
+//////// AzureRequestLogBuffer ////////
+AzureRequestLogBuffer::AzureRequestLogBuffer(idx_t capacity)
+    : capacity(capacity), slots(new Slot[capacity]), next_position(0) {
+}
+
+void AzureRequestLogBuffer::Add(const AzureRequestLogEntry &entry) {
+	auto position = next_position.fetch_add(1, std::memory_order_relaxed);
+	auto &slot = slots[position % capacity];
+	auto sequence = slot.sequence.load(std::memory_order_relaxed);
+	// The writers never wait: the entry is dropped if the slot is busy or already holds a newer entry
+	if ((sequence & SLOT_BUSY) != 0 || sequence > position ||
+	    !slot.sequence.compare_exchange_strong(sequence, SLOT_BUSY, std::memory_order_acquire,
+	                                           std::memory_order_relaxed)) {
+		return;
+	}
+	slot.entry = entry;
+	slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+vector<AzureRequestLogEntry> AzureRequestLogBuffer::Snapshot() const {
+	vector<std::pair<idx_t, AzureRequestLogEntry>> entries;
+	for (idx_t slot_idx = 0; slot_idx < capacity; slot_idx++) {
+		auto &slot = slots[slot_idx];
+		auto sequence = slot.sequence.load(std::memory_order_relaxed);
+		if (sequence == 0 || (sequence & SLOT_BUSY) != 0 ||
+		    !slot.sequence.compare_exchange_strong(sequence, sequence | SLOT_BUSY, std::memory_order_acquire,
+		                                           std::memory_order_relaxed)) {
+			// Empty, or being written
+			continue;
+		}
+		AzureRequestLogEntry entry = slot.entry;
+		slot.sequence.store(sequence, std::memory_order_release);
+		entries.emplace_back(sequence, entry);
+	}
+	std::sort(entries.begin(), entries.end(),
+	          [](const std::pair<idx_t, AzureRequestLogEntry> &a, const std::pair<idx_t, AzureRequestLogEntry> &b) {
+		          return a.first < b.first;
+	          });
+
+	vector<AzureRequestLogEntry> result;
+	result.reserve(entries.size());
+	for (auto &entry : entries) {
+		result.push_back(entry.second);
+	}
+	return result;
+}
+
+idx_t AzureRequestLogBuffer::GetCapacity() const {
+	return capacity;
+}
+
+//////// AzureRequestLog ////////
+shared_ptr<AzureRequestLog> AzureRequestLog::GetLog(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureRequestLog>(ObjectType());
+}
+
+shared_ptr<AzureRequestLogBuffer> AzureRequestLog::GetBuffer(idx_t capacity) {
+	lock_guard<mutex> guard(lock);
+	if (!buffer || buffer->GetCapacity() != capacity) {
+		buffer = make_shared_ptr<AzureRequestLogBuffer>(capacity);
+	}
+	return buffer;
+}
+
+shared_ptr<AzureRequestLogBuffer> AzureRequestLog::GetCurrentBuffer() {
+	lock_guard<mutex> guard(lock);
+	return buffer;
+}
+
+string AzureRequestLog::ObjectType() {
+	return "azure_request_log";
+}
+
+string AzureRequestLog::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -0,0 +1,152 @@
+#include "azure_request_metrics.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <cmath>
+
+namespace duckdb {
+
+//! Each power of 2 is split in 1 << SUB_BUCKET_BITS buckets
+static constexpr idx_t SUB_BUCKET_BITS = 2;
+static constexpr idx_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+constexpr idx_t AzureHistogram::BUCKET_COUNT;
+
+//////// AzureHistogram ////////
+AzureHistogram::AzureHistogram() {
+	Reset();
+}
+
+idx_t AzureHistogram::BucketIndex(idx_t value) {
+	if (value < SUB_BUCKET_COUNT) {
+		return value;
+	}
+	idx_t msb = 0;
+	for (auto shifted = value; shifted > 1; shifted >>= 1) {
+		msb++;
+	}
+	auto sub_bucket = (value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+	return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+idx_t AzureHistogram::BucketUpperBound(idx_t bucket) {
+	if (bucket < SUB_BUCKET_COUNT) {
+		return bucket;
+	}
+	auto msb = bucket / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+	auto sub_bucket = bucket % SUB_BUCKET_COUNT;
+	auto shift = msb - SUB_BUCKET_BITS;
+	if (msb == 63 && sub_bucket == SUB_BUCKET_COUNT - 1) {
+		return NumericLimits<idx_t>::Maximum();
+	}
+	return ((SUB_BUCKET_COUNT + sub_bucket + 1) << shift) - 1;
+}
+
+void AzureHistogram::Record(idx_t value) {
+	buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	auto current_max = max.load(std::memory_order_relaxed);
+	while (value > current_max && !max.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+	}
+}
+
+void AzureHistogram::Reset() {
+	for (auto &bucket : buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	count.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+idx_t AzureHistogram::Count() const {
+	return count.load(std::memory_order_relaxed);
+}
+
+idx_t AzureHistogram::Max() const {
+	return max.load(std::memory_order_relaxed);
+}
+
+idx_t AzureHistogram::Percentile(double percentile) const {
+	auto total = Count();
+	if (total == 0) {
+		return 0;
+	}
+	// Buckets can be updated concurrently, a percentile read during the query is approximate anyway
+	auto rank = MaxValue<idx_t>(static_cast<idx_t>(std::ceil(percentile * static_cast<double>(total))), 1);
+	idx_t seen = 0;
+	for (idx_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+		seen += buckets[bucket].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			return MinValue<idx_t>(BucketUpperBound(bucket), Max());
+		}
+	}
+	return Max();
+}
+
+//////// AzureRequestHistograms ////////
+void AzureRequestHistograms::Record(idx_t ttfb, idx_t latency, idx_t bytes) {
+	ttfb_us.Record(ttfb);
+	latency_us.Record(latency);
+	if (bytes > 0) {
+		throughput.Record(static_cast<idx_t>(static_cast<double>(bytes) * 1000000 /
+		                                     static_cast<double>(MaxValue<idx_t>(latency, 1))));
+	}
+}
+
+void AzureRequestHistograms::Reset() {
+	latency_us.Reset();
+	ttfb_us.Reset();
+	throughput.Reset();
+}
+
+const char *AzureRequestMethodToString(AzureRequestMethod method) {
+	switch (method) {
+	case AzureRequestMethod::HEAD:
+		return "HEAD";
+	case AzureRequestMethod::GET:
+		return "GET";
+	case AzureRequestMethod::PUT:
+		return "PUT";
+	case AzureRequestMethod::POST:
+		return "POST";
+	default:
+		return "OTHER";
+	}
+}
+
+//////// AzureRequestMetrics ////////
+shared_ptr<AzureRequestMetrics> AzureRequestMetrics::GetMetrics(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureRequestMetrics>(ObjectType());
+}
+
+shared_ptr<AzureRequestHistograms> AzureRequestMetrics::GetHistograms(const std::string &account,
+                                                                      AzureRequestMethod method) {
+	lock_guard<mutex> guard(lock);
+	auto &entry = histograms[key_t(account, method)];
+	if (!entry) {
+		entry = make_shared_ptr<AzureRequestHistograms>();
+	}
+	return entry;
+}
+
+vector<std::pair<AzureRequestMetrics::key_t, shared_ptr<AzureRequestHistograms>>> AzureRequestMetrics::GetAll() {
+	lock_guard<mutex> guard(lock);
+	vector<std::pair<key_t, shared_ptr<AzureRequestHistograms>>> result;
+	for (auto &entry : histograms) {
+		result.emplace_back(entry.first, entry.second);
+	}
+	return result;
+}
+
+void AzureRequestMetrics::Clear() {
+	lock_guard<mutex> guard(lock);
+	histograms.clear();
+}
+
+string AzureRequestMetrics::ObjectType() {
+	return "azure_request_metrics";
+}
+
+string AzureRequestMetrics::GetObjectType() {
+	return ObjectType();
+}
+
+} // namespace duckdb
@@ -0,0 +1,151 @@
+#include "azure_stats_functions.hpp"
+#include "azure_request_log.hpp"
+#include "azure_request_metrics.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+//////// azure_request_stats ////////
+struct AzureRequestStatsRow {
+	std::string account;
+	AzureRequestMethod method;
+	const char *metric;
+	const AzureHistogram *histogram;
+};
+
+struct AzureRequestStatsState : public GlobalTableFunctionState {
+	//! Keep the histograms alive while they are read
+	vector<std::pair<AzureRequestMetrics::key_t, shared_ptr<AzureRequestHistograms>>> histograms;
+	vector<AzureRequestStatsRow> rows;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> AzureRequestStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("account");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("method");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("metric");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("count");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("p50");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("p90");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("p99");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("max");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> AzureRequestStatsInit(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+	auto state = make_uniq<AzureRequestStatsState>();
+	state->histograms = AzureRequestMetrics::GetMetrics(context)->GetAll();
+	for (auto &entry : state->histograms) {
+		auto &account = entry.first.first;
+		auto method = entry.first.second;
+		auto &histograms = *entry.second;
+		state->rows.push_back({account, method, "latency_us", &histograms.latency_us});
+		state->rows.push_back({account, method, "ttfb_us", &histograms.ttfb_us});
+		state->rows.push_back({account, method, "throughput_bytes_per_sec", &histograms.throughput});
+	}
+	return std::move(state);
+}
+
+static void AzureRequestStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<AzureRequestStatsState>();
+	idx_t count = 0;
+	while (state.offset < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.offset++];
+		output.SetValue(0, count, Value(row.account));
+		output.SetValue(1, count, Value(AzureRequestMethodToString(row.method)));
+		output.SetValue(2, count, Value(row.metric));
+		output.SetValue(3, count, Value::UBIGINT(row.histogram->Count()));
+		output.SetValue(4, count, Value::UBIGINT(row.histogram->Percentile(0.5)));
+		output.SetValue(5, count, Value::UBIGINT(row.histogram->Percentile(0.9)));
+		output.SetValue(6, count, Value::UBIGINT(row.histogram->Percentile(0.99)));
+		output.SetValue(7, count, Value::UBIGINT(row.histogram->Max()));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//////// azure_request_log ////////
+struct AzureRequestLogState : public GlobalTableFunctionState {
+	vector<AzureRequestLogEntry> entries;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> AzureRequestLogBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("timestamp");
+	return_types.emplace_back(LogicalType::TIMESTAMP);
+	names.emplace_back("thread_id");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("method");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("host");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("path");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("range");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("status");
+	return_types.emplace_back(LogicalType::INTEGER);
+	names.emplace_back("bytes");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("latency_us");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("attempt");
+	return_types.emplace_back(LogicalType::INTEGER);
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> AzureRequestLogInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto state = make_uniq<AzureRequestLogState>();
+	auto buffer = AzureRequestLog::GetLog(context)->GetCurrentBuffer();
+	if (buffer) {
+		state->entries = buffer->Snapshot();
+	}
+	return std::move(state);
+}
+
+static void AzureRequestLogFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<AzureRequestLogState>();
+	idx_t count = 0;
+	while (state.offset < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = state.entries[state.offset++];
+		output.SetValue(0, count, Value::TIMESTAMP(entry.timestamp));
+		output.SetValue(1, count, Value::UBIGINT(entry.thread_id));
+		output.SetValue(2, count, Value(AzureRequestMethodToString(entry.method)));
+		output.SetValue(3, count, Value(string(entry.host)));
+		output.SetValue(4, count, Value(string(entry.path)));
+		output.SetValue(5, count, entry.range[0] == '\0' ? Value(LogicalType::VARCHAR) : Value(string(entry.range)));
+		output.SetValue(6, count, Value::INTEGER(entry.status));
+		output.SetValue(7, count, Value::UBIGINT(entry.bytes));
+		output.SetValue(8, count, Value::UBIGINT(entry.latency_us));
+		output.SetValue(9, count, Value::INTEGER(entry.attempt));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+void AzureStatsFunctions::Register(DatabaseInstance &instance) {
+	TableFunction request_stats_function("azure_request_stats", {}, AzureRequestStatsFunction, AzureRequestStatsBind,
+	                                     AzureRequestStatsInit);
+	ExtensionUtil::RegisterFunction(instance, request_stats_function);
+
+	TableFunction request_log_function("azure_request_log", {}, AzureRequestLogFunction, AzureRequestLogBind,
+	                                   AzureRequestLogInit);
+	ExtensionUtil::RegisterFunction(instance, request_log_function);
+}
+
+} // namespace duckdb
@@ -1,17 +1,22 @@
 #include "azure_storage_account_client.hpp"
+#include "azure_client_pool.hpp"
 
 #include "duckdb/catalog/catalog_transaction.hpp"
 #include "duckdb/common/enums/statement_type.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/helper.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/secret/secret.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
+#include "azure_throttling_policy.hpp"
+#include "azure_transport_registry.hpp"
 #include "http_state_policy.hpp"
+#include "mbedtls_wrapper.hpp"
 
 #include <azure/core/credentials/token_credential_options.hpp>
 #include <azure/core/http/curl_transport.hpp>
@@ -28,6 +33,7 @@
 
 #include <azure/storage/files/datalake/datalake_options.hpp>
 #include <azure/storage/files/datalake/datalake_service_client.hpp>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
@@ -76,34 +82,40 @@ static std::string AccountUrl(const AzureParsedUrl &azure_parsed_url) {
 	return AccountUrl(azure_parsed_url.storage_account_name, azure_parsed_url.endpoint);
 }
 
+//! SHA-256 of a configuration fingerprint, to key the shared objects without keeping the credentials it contains
+static std::string FingerprintDigest(const std::string &fingerprint) {
+	duckdb_mbedtls::MbedTlsWrapper::SHA256State state;
+	state.AddString(fingerprint);
+	return state.Finalize();
+}
+
 template <typename T>
-static T ToClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options,
-                         shared_ptr<AzureHTTPState> http_state) {
+static T ToClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options) {
 	static_assert(std::is_base_of<Azure::Core::_internal::ClientOptions, T>::value,
 	              "type parameter must be an Azure ClientOptions");
 	T options;
 	options.Transport = transport_options;
-	if (http_state != nullptr) {
-		// Because we mainly want to have stats on what has been needed and not on
-		// what has been used on the network, we register the policy on `PerOperationPolicies`
-		// part and not the `PerRetryPolicies`. Network issues will result in retry that can
-		// increase the input/output but will not be displayed in the EXPLAIN summary.
-		options.PerOperationPolicies.emplace_back(new HttpStatePolicy(std::move(http_state)));
-	}
+	// Because we mainly want to have stats on what has been needed and not on
+	// what has been used on the network, we register the policy on `PerOperationPolicies`
+	// part and not the `PerRetryPolicies`. Network issues will result in retry that can
+	// increase the input/output but will not be displayed in the EXPLAIN summary.
+	// The client can be shared between connections, the HTTP state to update is given by the request context.
+	options.PerOperationPolicies.emplace_back(new HttpStatePolicy());
+	// The governor must see every attempt, retries included, to slow them down when the account is throttling
+	options.PerRetryPolicies.emplace_back(new AzureThrottlingPolicy());
+	// The request log traces what is actually sent, and the latency histograms time it, so each attempt
+	options.PerRetryPolicies.emplace_back(new HttpStatePolicy(HttpStatePolicy::Stage::PER_RETRY));
 	return options;
 }
 
 static Azure::Storage::Blobs::BlobClientOptions
-ToBlobClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options,
-                    shared_ptr<AzureHTTPState> http_state) {
-	return ToClientOptions<Azure::Storage::Blobs::BlobClientOptions>(transport_options, std::move(http_state));
+ToBlobClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options) {
+	return ToClientOptions<Azure::Storage::Blobs::BlobClientOptions>(transport_options);
 }
 
 static Azure::Storage::Files::DataLake::DataLakeClientOptions
-ToDfsClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options,
-                   shared_ptr<AzureHTTPState> http_state) {
-	return ToClientOptions<Azure::Storage::Files::DataLake::DataLakeClientOptions>(transport_options,
-	                                                                               std::move(http_state));
+ToDfsClientOptions(const Azure::Core::Http::Policies::TransportOptions &transport_options) {
+	return ToClientOptions<Azure::Storage::Files::DataLake::DataLakeClientOptions>(transport_options);
 }
 
 static Azure::Core::Credentials::TokenCredentialOptions
@@ -113,21 +125,6 @@ ToTokenCredentialOptions(const Azure::Core::Http::Policies::TransportOptions &tr
 	return options;
 }
 
-static shared_ptr<AzureHTTPState> GetHttpState(optional_ptr<FileOpener> opener) {
-	Value value;
-	bool enable_http_stats = false;
-	if (FileOpener::TryGetCurrentSetting(opener, "azure_http_stats", value)) {
-		enable_http_stats = value.GetValue<bool>();
-	}
-
-	shared_ptr<AzureHTTPState> http_state;
-	if (enable_http_stats) {
-		http_state = AzureHTTPState::TryGetState(opener);
-	}
-
-	return http_state;
-}
-
 static std::shared_ptr<Azure::Core::Credentials::TokenCredential>
 CreateChainedTokenCredential(const std::string &chain,
                              const Azure::Core::Http::Policies::TransportOptions &transport_options) {
@@ -227,6 +224,33 @@ CreateAccessTokenCredential(const KeyValueSecret &secret) {
 	return std::make_shared<AccessTokenCredential>(access_token);
 }
 
+//! CA bundle of the system, looked up once per process
+static const char *GetSystemCABundle() {
+#if !defined(_WIN32) && !defined(__APPLE__)
+	static const char *ca_bundle = []() -> const char * {
+		// https://github.com/Azure/azure-sdk-for-cpp/issues/4983
+		// https://github.com/Azure/azure-sdk-for-cpp/issues/4738
+		for (const auto *path : {
+		         "/etc/ssl/certs/ca-certificates.crt",                // Debian/Ubuntu/Gentoo etc.
+		         "/etc/pki/tls/certs/ca-bundle.crt",                  // Fedora/RHEL 6
+		         "/etc/ssl/ca-bundle.pem",                            // OpenSUSE
+		         "/etc/pki/tls/cacert.pem",                           // OpenELEC
+		         "/etc/pki/ca-trust/extracted/pem/tls-ca-bundle.pem", // CentOS/RHEL 7
+		         "/etc/ssl/cert.pem"                                  // Alpine Linux
+		     }) {
+			if (FILE *f = fopen(path, "r")) {
+				fclose(f);
+				return path;
+			}
+		}
+		return nullptr;
+	}();
+	return ca_bundle;
+#else
+	return nullptr;
+#endif
+}
+
 static std::shared_ptr<Azure::Core::Http::HttpTransport>
 CreateCurlTransport(const std::string &proxy, const std::string &proxy_username, const std::string &proxy_password) {
 	Azure::Core::Http::CurlTransportOptions curl_transport_options;
@@ -244,26 +268,9 @@ CreateCurlTransport(const std::string &proxy, const std::string &proxy_username,
 	}
 
 	const char *ca_info = std::getenv("CURL_CA_INFO");
-#if !defined(_WIN32) && !defined(__APPLE__)
 	if (!ca_info) {
-		// https://github.com/Azure/azure-sdk-for-cpp/issues/4983
-		// https://github.com/Azure/azure-sdk-for-cpp/issues/4738
-		for (const auto *path : {
-		         "/etc/ssl/certs/ca-certificates.crt",                // Debian/Ubuntu/Gentoo etc.
-		         "/etc/pki/tls/certs/ca-bundle.crt",                  // Fedora/RHEL 6
-		         "/etc/ssl/ca-bundle.pem",                            // OpenSUSE
-		         "/etc/pki/tls/cacert.pem",                           // OpenELEC
-		         "/etc/pki/ca-trust/extracted/pem/tls-ca-bundle.pem", // CentOS/RHEL 7
-		         "/etc/ssl/cert.pem"                                  // Alpine Linux
-		     }) {
-			if (FILE *f = fopen(path, "r")) {
-				fclose(f);
-				ca_info = path;
-				break;
-			}
-		}
+		ca_info = GetSystemCABundle();
 	}
-#endif
 	if (ca_info) {
 		curl_transport_options.CAInfo = ca_info;
 	}
@@ -276,12 +283,62 @@ CreateCurlTransport(const std::string &proxy, const std::string &proxy_username,
 	return std::make_shared<Azure::Core::Http::CurlTransport>(curl_transport_options);
 }
 
-static Azure::Core::Http::Policies::TransportOptions GetTransportOptions(const std::string &transport_option_type,
-                                                                         const std::string &proxy,
-                                                                         const std::string &proxy_username,
-                                                                         const std::string &proxy_password) {
+static mutex transport_override_lock;
+static std::shared_ptr<Azure::Core::Http::HttpTransport> transport_override;
+
+void SetAzureTransportOverride(std::shared_ptr<Azure::Core::Http::HttpTransport> transport) {
+	lock_guard<mutex> guard(transport_override_lock);
+	transport_override = std::move(transport);
+}
+
+static std::shared_ptr<Azure::Core::Http::HttpTransport> GetTransportOverride() {
+	lock_guard<mutex> guard(transport_override_lock);
+	return transport_override;
+}
+
+//! What the SDK builds as default transport outside of Windows: libcurl with the proxy options
+static std::shared_ptr<Azure::Core::Http::HttpTransport> CreateDefaultTransport(const std::string &proxy,
+                                                                               const std::string &proxy_username,
+                                                                               const std::string &proxy_password) {
+	Azure::Core::Http::CurlTransportOptions curl_transport_options;
+	if (!proxy.empty()) {
+		curl_transport_options.Proxy = proxy;
+	}
+	if (!proxy_username.empty()) {
+		curl_transport_options.ProxyUsername = proxy_username;
+	}
+	if (!proxy_password.empty()) {
+		curl_transport_options.ProxyPassword = proxy_password;
+	}
+	return std::make_shared<Azure::Core::Http::CurlTransport>(curl_transport_options);
+}
+
+static AzureTransportPoolOptions GetTransportPoolOptions(optional_ptr<FileOpener> opener) {
+	AzureTransportPoolOptions pool_options;
+	Value pool_size_val;
+	if (FileOpener::TryGetCurrentSetting(opener, "azure_http_pool_size", pool_size_val)) {
+		pool_options.pool_size = pool_size_val.GetValue<idx_t>();
+	}
+	return pool_options;
+}
+
+static Azure::Core::Http::Policies::TransportOptions
+GetTransportOptions(const std::string &transport_option_type, const std::string &proxy,
+                    const std::string &proxy_username, const std::string &proxy_password,
+                    const AzureTransportPoolOptions &pool_options) {
 	Azure::Core::Http::Policies::TransportOptions transport_options;
+	auto override_transport = GetTransportOverride();
+	if (override_transport) {
+		transport_options.Transport = std::move(override_transport);
+		return transport_options;
+	}
+
+	if (transport_option_type != "default" && transport_option_type != "curl") {
+		throw InvalidInputException("transport_option_type cannot take value '%s'", transport_option_type);
+	}
+#ifdef _WIN32
 	if (transport_option_type == "default") {
+		// WinHTTP, built by the SDK
 		if (!proxy.empty()) {
 			transport_options.HttpProxy = proxy;
 		}
@@ -293,12 +350,27 @@ static Azure::Core::Http::Policies::TransportOptions GetTransportOptions(const s
 		if (!proxy_password.empty()) {
 			transport_options.ProxyPassword = proxy_password;
 		}
-	} else if (transport_option_type == "curl") {
-		transport_options.Transport = CreateCurlTransport(proxy, proxy_username, proxy_password);
-	} else {
-		throw InvalidInputException("transport_option_type cannot take value '%s'", transport_option_type);
+		return transport_options;
 	}
+#endif
 
+	// The transport is shared by all the clients with the same configuration, so are its connections
+	std::string fingerprint = transport_option_type + ';' + proxy + ';' + proxy_username + ';' + proxy_password + ';' +
+	                          std::to_string(pool_options.pool_size) + ';';
+	if (transport_option_type == "curl") {
+		for (const auto *variable : {"CURL_CA_INFO", "CURL_CA_PATH"}) {
+			auto *value = std::getenv(variable);
+			fingerprint += std::string(value ? value : "") + ';';
+		}
+	}
+	// The fingerprint holds the proxy password, only its digest is kept as the key
+	auto transport_key = FingerprintDigest(fingerprint);
+	transport_options.Transport = AzureTransportRegistry::Get().GetOrCreate(transport_key, pool_options, [&]() {
+		if (transport_option_type == "curl") {
+			return CreateCurlTransport(proxy, proxy_username, proxy_password);
+		}
+		return CreateDefaultTransport(proxy, proxy_username, proxy_password);
+	});
 	return transport_options;
 }
 
@@ -330,7 +402,8 @@ static Azure::Core::Http::Policies::TransportOptions GetTransportOptions(optiona
 		http_proxy_password = http_proxy_password_val.ToString();
 	}
 
-	return GetTransportOptions(transport_option_type, http_proxy, http_proxy_username, http_proxy_password);
+	return GetTransportOptions(transport_option_type, http_proxy, http_proxy_username, http_proxy_password,
+	                           GetTransportPoolOptions(opener));
 }
 
 static Azure::Storage::Blobs::BlobServiceClient
@@ -348,14 +421,14 @@ GetBlobStorageAccountClientFromConfigProvider(optional_ptr<FileOpener> opener, c
 			                            azure_parsed_url.storage_account_name);
 		}
 
-		auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+		auto blob_options = ToBlobClientOptions(transport_options);
 		return Azure::Storage::Blobs::BlobServiceClient::CreateFromConnectionString(connection_string, blob_options);
 	}
 
 	// Default provider (config) with no connection string => public storage account
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_BLOB_ENDPOINT);
-	auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+	auto blob_options = ToBlobClientOptions(transport_options);
 	return Azure::Storage::Blobs::BlobServiceClient(account_url, blob_options);
 }
 
@@ -374,7 +447,7 @@ GetDfsStorageAccountClientFromConfigProvider(optional_ptr<FileOpener> opener, co
 			                            azure_parsed_url.storage_account_name);
 		}
 
-		auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+		auto dfs_options = ToDfsClientOptions(transport_options);
 		return Azure::Storage::Files::DataLake::DataLakeServiceClient::CreateFromConnectionString(connection_string,
 		                                                                                          dfs_options);
 	}
@@ -382,7 +455,7 @@ GetDfsStorageAccountClientFromConfigProvider(optional_ptr<FileOpener> opener, co
 	// Default provider (config) with no connection string => public storage account
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_DFS_ENDPOINT);
-	auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+	auto dfs_options = ToDfsClientOptions(transport_options);
 	return Azure::Storage::Files::DataLake::DataLakeServiceClient(account_url, dfs_options);
 }
 
@@ -396,7 +469,7 @@ GetBlobStorageAccountClientFromCredentialChainProvider(optional_ptr<FileOpener>
 	// Connect to storage account
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_BLOB_ENDPOINT);
-	auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+	auto blob_options = ToBlobClientOptions(transport_options);
 	return Azure::Storage::Blobs::BlobServiceClient(account_url, std::move(credential), blob_options);
 }
 
@@ -410,7 +483,7 @@ GetDfsStorageAccountClientFromCredentialChainProvider(optional_ptr<FileOpener> o
 	// Connect to storage account
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_DFS_ENDPOINT);
-	auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+	auto dfs_options = ToDfsClientOptions(transport_options);
 	return Azure::Storage::Files::DataLake::DataLakeServiceClient(account_url, std::move(credential), dfs_options);
 }
 
@@ -423,7 +496,7 @@ GetBlobStorageAccountClientFromServicePrincipalProvider(optional_ptr<FileOpener>
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_BLOB_ENDPOINT);
 	;
-	auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+	auto blob_options = ToBlobClientOptions(transport_options);
 	return Azure::Storage::Blobs::BlobServiceClient(account_url, token_credential, blob_options);
 }
 
@@ -436,7 +509,7 @@ GetDfsStorageAccountClientFromServicePrincipalProvider(optional_ptr<FileOpener>
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_DFS_ENDPOINT);
 	;
-	auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+	auto dfs_options = ToDfsClientOptions(transport_options);
 	return Azure::Storage::Files::DataLake::DataLakeServiceClient(account_url, token_credential, dfs_options);
 }
 
@@ -449,7 +522,7 @@ GetBlobStorageAccountClientFromAccessTokenProvider(optional_ptr<FileOpener> open
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_BLOB_ENDPOINT);
 	;
-	auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+	auto blob_options = ToBlobClientOptions(transport_options);
 	return Azure::Storage::Blobs::BlobServiceClient(account_url, token_credential, blob_options);
 }
 
@@ -462,7 +535,7 @@ GetDfsStorageAccountClientFromAccessTokenProvider(optional_ptr<FileOpener> opene
 	auto account_url =
 	    azure_parsed_url.is_fully_qualified ? AccountUrl(azure_parsed_url) : AccountUrl(secret, DEFAULT_DFS_ENDPOINT);
 	;
-	auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+	auto dfs_options = ToDfsClientOptions(transport_options);
 	return Azure::Storage::Files::DataLake::DataLakeServiceClient(account_url, token_credential, dfs_options);
 }
 
@@ -510,14 +583,15 @@ static Azure::Core::Http::Policies::TransportOptions GetTransportOptions(optiona
 	auto http_proxy_user_name = TryGetCurrentSetting(opener, "azure_proxy_user_name");
 	auto http_proxy_password = TryGetCurrentSetting(opener, "azure_proxy_password");
 
-	return GetTransportOptions(azure_transport_option_type, http_proxy, http_proxy_user_name, http_proxy_password);
+	return GetTransportOptions(azure_transport_option_type, http_proxy, http_proxy_user_name, http_proxy_password,
+	                           GetTransportPoolOptions(opener));
 }
 
 static Azure::Storage::Blobs::BlobServiceClient GetBlobStorageAccountClient(optional_ptr<FileOpener> opener,
                                                                             const std::string &provided_storage_account,
                                                                             const std::string &provided_endpoint) {
 	auto transport_options = GetTransportOptions(opener);
-	auto blob_options = ToBlobClientOptions(transport_options, GetHttpState(opener));
+	auto blob_options = ToBlobClientOptions(transport_options);
 
 	auto connection_string = TryGetCurrentSetting(opener, "azure_storage_connection_string");
 	if (!connection_string.empty() &&
@@ -569,11 +643,43 @@ const SecretMatch LookupSecret(optional_ptr<FileOpener> opener, const std::strin
 	return {};
 }
 
-Azure::Storage::Blobs::BlobServiceClient ConnectToBlobStorageAccount(optional_ptr<FileOpener> opener,
-                                                                     const std::string &path,
-                                                                     const AzureParsedUrl &azure_parsed_url) {
+static std::string ClientPoolKey(optional_ptr<FileOpener> opener, const SecretMatch &secret_match,
+                                 const AzureParsedUrl &azure_parsed_url) {
+	// Everything that can influence the construction of a client has to be part of the key
+	std::string fingerprint = azure_parsed_url.storage_account_name + ';' + azure_parsed_url.endpoint + ';';
 
-	auto secret_match = LookupSecret(opener, path);
+	// Transport
+	for (const auto *setting : {"azure_transport_option_type", "azure_http_proxy", "azure_proxy_user_name",
+	                            "azure_proxy_password", "azure_http_pool_size"}) {
+		fingerprint += TryGetCurrentSetting(opener, setting) + ';';
+	}
+	auto *http_proxy_env = std::getenv("HTTP_PROXY");
+	if (http_proxy_env != nullptr) {
+		fingerprint += http_proxy_env;
+	}
+	fingerprint += ';';
+	fingerprint += std::to_string(reinterpret_cast<uintptr_t>(GetTransportOverride().get())) + ';';
+
+	// Credentials
+	if (secret_match.HasMatch()) {
+		const auto &secret = dynamic_cast<const KeyValueSecret &>(secret_match.GetSecret());
+		fingerprint += "secret;" + secret.GetName() + ';' + secret.GetProvider() + ';';
+		for (const auto &entry : secret.secret_map) {
+			fingerprint += entry.first + '=' + entry.second.ToString() + ';';
+		}
+	} else {
+		for (const auto *setting :
+		     {"azure_storage_connection_string", "azure_account_name", "azure_endpoint", "azure_credential_chain"}) {
+			fingerprint += TryGetCurrentSetting(opener, setting) + ';';
+		}
+	}
+	// The pooled clients outlive the secrets, the key must not hold them in clear
+	return FingerprintDigest(fingerprint);
+}
+
+static Azure::Storage::Blobs::BlobServiceClient CreateBlobStorageAccountClient(optional_ptr<FileOpener> opener,
+                                                                               const SecretMatch &secret_match,
+                                                                               const AzureParsedUrl &azure_parsed_url) {
 	if (secret_match.HasMatch()) {
 		const auto &base_secret = secret_match.GetSecret();
 		return GetBlobStorageAccountClient(opener, dynamic_cast<const KeyValueSecret &>(base_secret), azure_parsed_url);
@@ -583,10 +689,9 @@ Azure::Storage::Blobs::BlobServiceClient ConnectToBlobStorageAccount(optional_pt
 	return GetBlobStorageAccountClient(opener, azure_parsed_url.storage_account_name, azure_parsed_url.endpoint);
 }
 
-Azure::Storage::Files::DataLake::DataLakeServiceClient
-ConnectToDfsStorageAccount(optional_ptr<FileOpener> opener, const std::string &path,
-                           const AzureParsedUrl &azure_parsed_url) {
-	auto secret_match = LookupSecret(opener, path);
+static Azure::Storage::Files::DataLake::DataLakeServiceClient
+CreateDfsStorageAccountClient(optional_ptr<FileOpener> opener, const std::string &path,
+                              const SecretMatch &secret_match, const AzureParsedUrl &azure_parsed_url) {
 	if (secret_match.HasMatch()) {
 		const auto &base_secret = secret_match.GetSecret();
 		return GetDfsStorageAccountClient(opener, dynamic_cast<const KeyValueSecret &>(base_secret), azure_parsed_url);
@@ -602,8 +707,36 @@ ConnectToDfsStorageAccount(optional_ptr<FileOpener> opener, const std::string &p
 	// No secret but FQDN has been provided, connect to a public storage account
 	auto transport_options = GetTransportOptions(opener);
 	auto account_url = "https://" + azure_parsed_url.storage_account_name + '.' + azure_parsed_url.endpoint;
-	auto dfs_options = ToDfsClientOptions(transport_options, GetHttpState(opener));
+	auto dfs_options = ToDfsClientOptions(transport_options);
 	return Azure::Storage::Files::DataLake::DataLakeServiceClient(account_url, dfs_options);
 }
 
-} // namespace duckdb
\ No newline at end of file
+Azure::Storage::Blobs::BlobServiceClient ConnectToBlobStorageAccount(optional_ptr<FileOpener> opener,
+                                                                     const std::string &path,
+                                                                     const AzureParsedUrl &azure_parsed_url) {
+	auto secret_match = LookupSecret(opener, path);
+
+	auto pool = AzureClientPool::TryGetPool(opener);
+	if (!pool) {
+		return CreateBlobStorageAccountClient(opener, secret_match, azure_parsed_url);
+	}
+	return pool->GetOrCreateBlobClient(ClientPoolKey(opener, secret_match, azure_parsed_url), [&]() {
+		return CreateBlobStorageAccountClient(opener, secret_match, azure_parsed_url);
+	});
+}
+
+Azure::Storage::Files::DataLake::DataLakeServiceClient
+ConnectToDfsStorageAccount(optional_ptr<FileOpener> opener, const std::string &path,
+                           const AzureParsedUrl &azure_parsed_url) {
+	auto secret_match = LookupSecret(opener, path);
+
+	auto pool = AzureClientPool::TryGetPool(opener);
+	if (!pool) {
+		return CreateDfsStorageAccountClient(opener, path, secret_match, azure_parsed_url);
+	}
+	return pool->GetOrCreateDfsClient(ClientPoolKey(opener, secret_match, azure_parsed_url), [&]() {
+		return CreateDfsStorageAccountClient(opener, path, secret_match, azure_parsed_url);
+	});
+}
+
+} // namespace duckdb
@@ -0,0 +1,211 @@
+#include "azure_throttling_policy.hpp"
+#include "http_state_policy.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace duckdb {
+
+//! Longest wait without checking whether the request has been cancelled
+static constexpr std::chrono::milliseconds MAX_WAIT_STEP(100);
+static constexpr std::chrono::milliseconds MIN_BACKOFF(100);
+static constexpr std::chrono::milliseconds MAX_BACKOFF(10000);
+
+const Azure::Core::Context::Key AzureThrottlingPolicy::GOVERNORS_KEY;
+
+//////// AzureAccountGovernor ////////
+AzureAccountGovernor::AzureAccountGovernor(idx_t max_in_flight, double max_request_rate)
+    : max_in_flight(max_in_flight), in_flight_limit(max_in_flight), in_flight(0), success_count(0),
+      max_request_rate(max_request_rate), tokens(0), last_refill(clock_t::now()), paused_until(clock_t::now()),
+      backoff(MIN_BACKOFF) {
+}
+
+void AzureAccountGovernor::Configure(idx_t new_max_in_flight, double new_max_request_rate) {
+	lock_guard<mutex> guard(lock);
+	if (new_max_in_flight != max_in_flight) {
+		max_in_flight = new_max_in_flight;
+		in_flight_limit = new_max_in_flight;
+		success_count = 0;
+	}
+	max_request_rate = new_max_request_rate;
+	released.notify_all();
+}
+
+AzureAccountGovernor::clock_t::time_point AzureAccountGovernor::TryAcquire(clock_t::time_point now) {
+	if (now < paused_until) {
+		return paused_until;
+	}
+	if (max_request_rate <= 0) {
+		return now;
+	}
+
+	// Refill the bucket, it holds up to one second of requests
+	auto elapsed = std::chrono::duration<double>(now - last_refill).count();
+	tokens = std::min(std::max(max_request_rate, 1.0), tokens + elapsed * max_request_rate);
+	last_refill = now;
+	if (tokens >= 1) {
+		tokens -= 1;
+		return now;
+	}
+	auto missing = std::chrono::duration<double>((1 - tokens) / max_request_rate);
+	return now + std::chrono::duration_cast<clock_t::duration>(missing);
+}
+
+int64_t AzureAccountGovernor::Acquire(const Azure::Core::Context &context) {
+	auto start = clock_t::now();
+	std::unique_lock<mutex> guard(lock);
+	while (true) {
+		context.ThrowIfCancelled();
+		auto now = clock_t::now();
+		auto wait_until = now + MAX_WAIT_STEP;
+		if (in_flight < in_flight_limit) {
+			auto next = TryAcquire(now);
+			if (next <= now) {
+				in_flight++;
+				break;
+			}
+			wait_until = std::min(wait_until, next);
+		}
+		released.wait_until(guard, wait_until);
+	}
+	return std::chrono::duration_cast<std::chrono::microseconds>(clock_t::now() - start).count();
+}
+
+void AzureAccountGovernor::Release(bool throttled, std::chrono::milliseconds retry_after) {
+	{
+		lock_guard<mutex> guard(lock);
+		in_flight--;
+		if (throttled) {
+			// Multiplicative decrease, and a pause for every sender of the account
+			in_flight_limit = std::max<idx_t>(in_flight_limit / 2, 1);
+			success_count = 0;
+			auto delay = retry_after.count() > 0 ? retry_after : backoff;
+			backoff = std::min(backoff * 2, MAX_BACKOFF);
+			paused_until = std::max(paused_until, clock_t::now() + delay);
+		} else {
+			backoff = MIN_BACKOFF;
+			success_count++;
+			if (success_count >= in_flight_limit && in_flight_limit < max_in_flight) {
+				in_flight_limit++;
+				success_count = 0;
+			}
+		}
+	}
+	released.notify_all();
+}
+
+idx_t AzureAccountGovernor::GetInFlightLimit() {
+	lock_guard<mutex> guard(lock);
+	return in_flight_limit;
+}
+
+idx_t AzureAccountGovernor::GetInFlightCount() {
+	lock_guard<mutex> guard(lock);
+	return in_flight;
+}
+
+//////// AzureAccountGovernors ////////
+shared_ptr<AzureAccountGovernors> AzureAccountGovernors::GetGovernors(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AzureAccountGovernors>(ObjectType());
+}
+
+void AzureAccountGovernors::Configure(idx_t new_max_in_flight, double new_max_request_rate) {
+	lock_guard<mutex> guard(lock);
+	if (new_max_in_flight == max_in_flight && new_max_request_rate == max_request_rate) {
+		return;
+	}
+	max_in_flight = new_max_in_flight;
+	max_request_rate = new_max_request_rate;
+	for (auto &entry : governors) {
+		entry.second->Configure(max_in_flight, max_request_rate);
+	}
+}
+
+shared_ptr<AzureAccountGovernor> AzureAccountGovernors::GetGovernor(const std::string &host) {
+	lock_guard<mutex> guard(lock);
+	auto &governor = governors[host];
+	if (!governor) {
+		governor = make_shared_ptr<AzureAccountGovernor>(max_in_flight, max_request_rate);
+	}
+	return governor;
+}
+
+string AzureAccountGovernors::ObjectType() {
+	return "azure_account_governors";
+}
+
+string AzureAccountGovernors::GetObjectType() {
+	return ObjectType();
+}
+
+//////// AzureThrottlingPolicy ////////
+Azure::Core::Context AzureThrottlingPolicy::AttachGovernors(const Azure::Core::Context &context,
+                                                            shared_ptr<AzureAccountGovernors> governors) {
+	return context.WithValue(GOVERNORS_KEY, std::move(governors));
+}
+
+std::chrono::milliseconds AzureThrottlingPolicy::GetRetryAfter(const Azure::Core::Http::RawResponse &response) {
+	const auto &headers = response.GetHeaders();
+	try {
+		auto retry_after_ms = headers.find("x-ms-retry-after-ms");
+		if (retry_after_ms != headers.end()) {
+			return std::chrono::milliseconds(std::stoll(retry_after_ms->second));
+		}
+		auto retry_after = headers.find("retry-after");
+		if (retry_after != headers.end()) {
+			return std::chrono::seconds(std::stoll(retry_after->second));
+		}
+	} catch (const std::exception &) {
+		// Not a number (an HTTP date), fall back to our own backoff
+	}
+	return std::chrono::milliseconds(0);
+}
+
+std::unique_ptr<Azure::Core::Http::RawResponse>
+AzureThrottlingPolicy::Send(Azure::Core::Http::Request &request,
+                            Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+                            Azure::Core::Context const &context) const {
+	using HttpStatusCode = Azure::Core::Http::HttpStatusCode;
+
+	shared_ptr<AzureAccountGovernors> governors;
+	if (!context.TryGetValue(GOVERNORS_KEY, governors) || !governors) {
+		// The governor is not enabled for the connection that issued this request
+		return next_policy.Send(request, context);
+	}
+
+	auto governor = governors->GetGovernor(request.GetUrl().GetHost());
+	auto wait_us = governor->Acquire(context);
+	auto http_state = HttpStatePolicy::TryGetHttpState(context);
+	if (http_state) {
+		http_state->throttle_wait_us += static_cast<idx_t>(wait_us);
+	}
+
+	std::unique_ptr<Azure::Core::Http::RawResponse> response;
+	try {
+		response = next_policy.Send(request, context);
+	} catch (...) {
+		// Transport error, not a signal from the service
+		governor->Release(false, std::chrono::milliseconds(0));
+		throw;
+	}
+
+	auto status_code = response->GetStatusCode();
+	bool throttled =
+	    status_code == HttpStatusCode::TooManyRequests || status_code == HttpStatusCode::ServiceUnavailable;
+	auto retry_after = throttled ? GetRetryAfter(*response) : std::chrono::milliseconds(0);
+	if (throttled && http_state) {
+		http_state->throttled_count++;
+	}
+	// A download still loads the account while its body is streamed, the slot is given back once it is read
+	OnResponseFinished(*response, [governor, throttled, retry_after](idx_t bytes_read) {
+		governor->Release(throttled, retry_after);
+	});
+	return response;
+}
+
+std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> AzureThrottlingPolicy::Clone() const {
+	return std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>(new AzureThrottlingPolicy());
+}
+
+} // namespace duckdb
@@ -0,0 +1,84 @@
+#include "azure_timer.hpp"
+
+namespace duckdb {
+
+constexpr idx_t AzureTimer::IDLE_TIMEOUT_MS;
+
+AzureTimer::AzureTimer() : next_timer_id(1), running_timer_id(0), worker_running(false), shutdown(false) {
+}
+
+AzureTimer::~AzureTimer() {
+	{
+		lock_guard<mutex> guard(lock);
+		shutdown = true;
+		timers.clear();
+		deadlines.clear();
+	}
+	timers_changed.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+idx_t AzureTimer::Schedule(clock_t::time_point deadline, callback_t callback) {
+	idx_t timer_id;
+	{
+		lock_guard<mutex> guard(lock);
+		timer_id = next_timer_id++;
+		timers.emplace(timer_key_t(deadline, timer_id), std::move(callback));
+		deadlines.emplace(timer_id, deadline);
+		if (!worker_running) {
+			if (worker.joinable()) {
+				// It exited because it was idle, it does not use the lock anymore
+				worker.join();
+			}
+			worker_running = true;
+			worker = std::thread([this]() { Work(); });
+		}
+	}
+	timers_changed.notify_all();
+	return timer_id;
+}
+
+void AzureTimer::Cancel(idx_t timer_id) {
+	std::unique_lock<mutex> guard(lock);
+	auto deadline = deadlines.find(timer_id);
+	if (deadline != deadlines.end()) {
+		timers.erase(timer_key_t(deadline->second, timer_id));
+		deadlines.erase(deadline);
+		return;
+	}
+	callback_finished.wait(guard, [&]() { return running_timer_id != timer_id; });
+}
+
+void AzureTimer::Work() {
+	std::unique_lock<mutex> guard(lock);
+	while (!shutdown) {
+		if (timers.empty()) {
+			auto has_timer = timers_changed.wait_for(guard, std::chrono::milliseconds(IDLE_TIMEOUT_MS),
+			                                         [&]() { return shutdown || !timers.empty(); });
+			if (!has_timer) {
+				worker_running = false;
+				return;
+			}
+			continue;
+		}
+		auto next = timers.begin();
+		if (next->first.first > clock_t::now()) {
+			timers_changed.wait_until(guard, next->first.first);
+			continue;
+		}
+
+		auto callback = std::move(next->second);
+		running_timer_id = next->first.second;
+		deadlines.erase(running_timer_id);
+		timers.erase(next);
+		guard.unlock();
+		callback();
+		guard.lock();
+		running_timer_id = 0;
+		callback_finished.notify_all();
+	}
+}
+
+} // namespace duckdb
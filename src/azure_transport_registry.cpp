@@ -0,0 +1,74 @@
+#include "azure_transport_registry.hpp"
+#include "http_state_policy.hpp"
+#include <azure/core/http/raw_response.hpp>
+#include <utility>
+
+namespace duckdb {
+
+constexpr idx_t AzureTransportRegistry::MAX_TRANSPORTS;
+
+//////// AzurePooledTransport ////////
+AzurePooledTransport::AzurePooledTransport(std::shared_ptr<Azure::Core::Http::HttpTransport> inner,
+                                           AzureTransportPoolOptions options)
+    : inner(std::move(inner)), options(options), in_flight(0) {
+}
+
+std::unique_ptr<Azure::Core::Http::RawResponse> AzurePooledTransport::Send(Azure::Core::Http::Request &request,
+                                                                           Azure::Core::Context const &context) {
+	if (options.pool_size == 0) {
+		return inner->Send(request, context);
+	}
+
+	Acquire(context);
+	std::unique_ptr<Azure::Core::Http::RawResponse> response;
+	try {
+		response = inner->Send(request, context);
+	} catch (...) {
+		Release();
+		throw;
+	}
+	// The connection stays busy until the body has been read (or the response destroyed)
+	auto self = shared_from_this();
+	OnResponseFinished(*response, [self](idx_t bytes_read) { self->Release(); });
+	return response;
+}
+
+void AzurePooledTransport::Acquire(const Azure::Core::Context &context) {
+	std::unique_lock<mutex> guard(lock);
+	context.ThrowIfCancelled();
+	slot_released.wait(guard, [&]() { return in_flight < options.pool_size || context.IsCancelled(); });
+	context.ThrowIfCancelled();
+	in_flight++;
+}
+
+void AzurePooledTransport::Release() {
+	{
+		lock_guard<mutex> guard(lock);
+		in_flight--;
+	}
+	slot_released.notify_one();
+}
+
+//////// AzureTransportRegistry ////////
+AzureTransportRegistry &AzureTransportRegistry::Get() {
+	static AzureTransportRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<AzurePooledTransport>
+AzureTransportRegistry::GetOrCreate(const std::string &key, const AzureTransportPoolOptions &options,
+                                    const std::function<std::shared_ptr<Azure::Core::Http::HttpTransport>()> &create) {
+	lock_guard<mutex> guard(lock);
+	auto entry = transports.find(key);
+	if (entry != transports.end()) {
+		return entry->second;
+	}
+	if (transports.size() >= MAX_TRANSPORTS) {
+		transports.clear();
+	}
+	auto transport = std::make_shared<AzurePooledTransport>(create(), options);
+	transports[key] = transport;
+	return transport;
+}
+
+} // namespace duckdb
@@ -1,7 +1,12 @@
 #include "http_state_policy.hpp"
 #include <azure/core/http/http.hpp>
+#include <azure/core/io/body_stream.hpp>
 #include "duckdb/common/shared_ptr.hpp"
+#include <azure/core/http/policies/policy.hpp>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <thread>
 #include <string>
 #include <utility>
 
@@ -9,39 +14,190 @@ const static std::string CONTENT_LENGTH = "content-length";
 
 namespace duckdb {
 
-HttpStatePolicy::HttpStatePolicy(shared_ptr<AzureHTTPState> http_state) : http_state(std::move(http_state)) {
+const Azure::Core::Context::Key HttpStatePolicy::HTTP_STATE_KEY;
+const Azure::Core::Context::Key HttpStatePolicy::REQUEST_METRICS_KEY;
+const Azure::Core::Context::Key HttpStatePolicy::REQUEST_LOG_KEY;
+const Azure::Core::Context::Key HttpStatePolicy::ATTEMPT_COUNTER_KEY;
+
+namespace {
+
+//! Records the timings of a request in the query HTTP state and in the database metrics
+struct RequestTimingRecorder {
+	shared_ptr<AzureHTTPState> http_state;
+	shared_ptr<AzureRequestHistograms> account_histograms;
+	AzureRequestMethod method;
+	std::chrono::steady_clock::time_point start;
+	idx_t ttfb_us;
+
+	void Record(idx_t bytes) const {
+		auto latency_us = static_cast<idx_t>(
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		if (http_state) {
+			http_state->method_histograms[static_cast<idx_t>(method)].Record(ttfb_us, latency_us, bytes);
+		}
+		if (account_histograms) {
+			account_histograms->Record(ttfb_us, latency_us, bytes);
+		}
+	}
+};
+
+//! Response body read by the caller after the pipeline returned (e.g. downloads), the request ends with the body
+class TimedBodyStream : public Azure::Core::IO::BodyStream {
+public:
+	using finish_function_t = std::function<void(idx_t bytes_read)>;
+
+	TimedBodyStream(std::unique_ptr<Azure::Core::IO::BodyStream> inner, finish_function_t on_finish)
+	    : inner(std::move(inner)), on_finish(std::move(on_finish)), bytes_read(0), finished(false) {
+	}
+	~TimedBodyStream() override {
+		// The body has not been read until the end (e.g. cancelled download)
+		try {
+			Finish();
+		} catch (...) {
+		}
+	}
+
+	int64_t Length() const override {
+		return inner->Length();
+	}
+	void Rewind() override {
+		inner->Rewind();
+		bytes_read = 0;
+	}
+
+private:
+	size_t OnRead(uint8_t *buffer, size_t count, Azure::Core::Context const &context) override {
+		auto read = inner->Read(buffer, count, context);
+		bytes_read += read;
+		if (read == 0 && count > 0) {
+			Finish();
+		}
+		return read;
+	}
+
+	void Finish() {
+		if (!finished) {
+			finished = true;
+			on_finish(bytes_read);
+		}
+	}
+
+private:
+	std::unique_ptr<Azure::Core::IO::BodyStream> inner;
+	finish_function_t on_finish;
+	idx_t bytes_read;
+	bool finished;
+};
+
+} // namespace
+
+void OnResponseFinished(Azure::Core::Http::RawResponse &response, std::function<void(idx_t bytes_read)> on_finish) {
+	auto body_stream = response.ExtractBodyStream();
+	if (body_stream) {
+		response.SetBodyStream(std::unique_ptr<Azure::Core::IO::BodyStream>(
+		    new TimedBodyStream(std::move(body_stream), std::move(on_finish))));
+	} else {
+		on_finish(response.GetBody().size());
+	}
+}
+
+static AzureRequestMethod ToRequestMethod(const Azure::Core::Http::HttpMethod &method) {
+	using HttpMethod = ::Azure::Core::Http::HttpMethod;
+	if (HttpMethod::Head == method) {
+		return AzureRequestMethod::HEAD;
+	} else if (HttpMethod::Get == method) {
+		return AzureRequestMethod::GET;
+	} else if (HttpMethod::Put == method) {
+		return AzureRequestMethod::PUT;
+	} else if (HttpMethod::Post == method) {
+		return AzureRequestMethod::POST;
+	}
+	return AzureRequestMethod::OTHER;
+}
+
+Azure::Core::Context HttpStatePolicy::AttachHttpState(const Azure::Core::Context &context,
+                                                      shared_ptr<AzureHTTPState> http_state) {
+	return context.WithValue(HTTP_STATE_KEY, std::move(http_state));
+}
+
+Azure::Core::Context HttpStatePolicy::AttachRequestMetrics(const Azure::Core::Context &context,
+                                                           shared_ptr<AzureRequestMetrics> request_metrics) {
+	return context.WithValue(REQUEST_METRICS_KEY, std::move(request_metrics));
+}
+
+Azure::Core::Context HttpStatePolicy::AttachRequestLog(const Azure::Core::Context &context,
+                                                       shared_ptr<AzureRequestLogBuffer> request_log) {
+	return context.WithValue(REQUEST_LOG_KEY, std::move(request_log));
+}
+
+shared_ptr<AzureHTTPState> HttpStatePolicy::TryGetHttpState(const Azure::Core::Context &context) {
+	shared_ptr<AzureHTTPState> http_state;
+	if (!context.TryGetValue(HTTP_STATE_KEY, http_state)) {
+		return nullptr;
+	}
+	return http_state;
 }
 
 std::unique_ptr<Azure::Core::Http::RawResponse>
 HttpStatePolicy::Send(Azure::Core::Http::Request &request, Azure::Core::Http::Policies::NextHttpPolicy next_policy,
                       Azure::Core::Context const &context) const {
+	if (stage == Stage::PER_RETRY) {
+		return SendAttempt(request, next_policy, context);
+	}
+
+	shared_ptr<AzureRequestLogBuffer> request_log;
+	if (context.TryGetValue(REQUEST_LOG_KEY, request_log) && request_log) {
+		// The attempts of this operation are numbered by the traced requests
+		auto attempt_context = context.WithValue(ATTEMPT_COUNTER_KEY, make_shared_ptr<atomic<int32_t>>(0));
+		return SendOperation(request, next_policy, attempt_context);
+	}
+	return SendOperation(request, next_policy, context);
+}
+
+std::unique_ptr<Azure::Core::Http::RawResponse>
+HttpStatePolicy::SendOperation(Azure::Core::Http::Request &request,
+                               Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+                               Azure::Core::Context const &context) const {
 	using HttpMethod = ::Azure::Core::Http::HttpMethod;
 
-	// The fact that there is a Clone method in the Azure SDK let me think that the SDK duplicate
-	// the policy internally (probably because of multi threading). So we should probably add a mutex
-	// here to keep things coherent, but we are only computing some stats (that already use the atomic
-	// type) so if the result is not completely exact it will not matter that much.
+	shared_ptr<AzureHTTPState> http_state;
+	context.TryGetValue(HTTP_STATE_KEY, http_state);
+	shared_ptr<AzureRequestMetrics> request_metrics;
+	context.TryGetValue(REQUEST_METRICS_KEY, request_metrics);
+	if (!http_state && !request_metrics) {
+		// Stats are not enabled for the connection that issued this request
+		return next_policy.Send(request, context);
+	}
 
 	const auto &method = request.GetMethod();
+	if (http_state) {
+		// The fact that there is a Clone method in the Azure SDK let me think that the SDK duplicate
+		// the policy internally (probably because of multi threading). So we should probably add a mutex
+		// here to keep things coherent, but we are only computing some stats (that already use the atomic
+		// type) so if the result is not completely exact it will not matter that much.
+		if (HttpMethod::Head == method) {
+			http_state->head_count++;
+		} else if (HttpMethod::Get == method) {
+			http_state->get_count++;
+		} else if (HttpMethod::Put == method) {
+			http_state->put_count++;
+		} else if (HttpMethod::Post == method) {
+			http_state->post_count++;
+		}
 
-	if (HttpMethod::Head == method) {
-		http_state->head_count++;
-	} else if (HttpMethod::Get == method) {
-		http_state->get_count++;
-	} else if (HttpMethod::Put == method) {
-		http_state->put_count++;
-	} else if (HttpMethod::Post == method) {
-		http_state->post_count++;
+		const auto *body_stream = request.GetBodyStream();
+		if (body_stream != nullptr) {
+			http_state->total_bytes_sent += body_stream->Length();
+		}
 	}
 
-	const auto *body_stream = request.GetBodyStream();
-	if (body_stream != nullptr) {
-		http_state->total_bytes_sent += body_stream->Length();
+	auto result = next_policy.Send(request, context);
+	if (result == nullptr) {
+		return result;
 	}
 
-	auto result = next_policy.Send(request, context);
-	if (result != nullptr) {
-		const auto &response_body = result->GetBody();
+	const auto &response_body = result->GetBody();
+	if (http_state) {
 		if (response_body.size() != 0) {
 			http_state->total_bytes_received += response_body.size();
 		} else {
@@ -56,12 +212,102 @@ HttpStatePolicy::Send(Azure::Core::Http::Request &request, Azure::Core::Http::Po
 			}
 		}
 	}
+	return result;
+}
+
+std::unique_ptr<Azure::Core::Http::RawResponse>
+HttpStatePolicy::SendAttempt(Azure::Core::Http::Request &request,
+                             Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+                             Azure::Core::Context const &context) const {
+	shared_ptr<AzureHTTPState> http_state;
+	context.TryGetValue(HTTP_STATE_KEY, http_state);
+	shared_ptr<AzureRequestMetrics> request_metrics;
+	context.TryGetValue(REQUEST_METRICS_KEY, request_metrics);
+	if (!http_state && !request_metrics) {
+		return SendTraced(request, next_policy, context);
+	}
+
+	// Each attempt is timed on its own, the backoff between the retries is not part of the latency
+	RequestTimingRecorder recorder;
+	recorder.http_state = http_state;
+	recorder.method = ToRequestMethod(request.GetMethod());
+	if (request_metrics) {
+		recorder.account_histograms = request_metrics->GetHistograms(request.GetUrl().GetHost(), recorder.method);
+	}
+	recorder.start = std::chrono::steady_clock::now();
+
+	auto result = SendTraced(request, next_policy, context);
+	if (result == nullptr) {
+		return result;
+	}
+	recorder.ttfb_us = static_cast<idx_t>(
+	    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - recorder.start)
+	        .count());
+
+	// Downloads return before their body is read, the request is only complete once the body stream is consumed
+	OnResponseFinished(*result, [recorder](idx_t bytes) { recorder.Record(bytes); });
+	return result;
+}
+
+std::unique_ptr<Azure::Core::Http::RawResponse>
+HttpStatePolicy::SendTraced(Azure::Core::Http::Request &request,
+                            Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+                            Azure::Core::Context const &context) const {
+	shared_ptr<AzureRequestLogBuffer> request_log;
+	if (!context.TryGetValue(REQUEST_LOG_KEY, request_log) || !request_log) {
+		// The request log is not enabled for the connection that issued this request
+		return next_policy.Send(request, context);
+	}
+
+	AzureRequestLogEntry entry;
+	entry.timestamp = Timestamp::GetCurrentTimestamp();
+	entry.thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+	entry.method = ToRequestMethod(request.GetMethod());
+	entry.status = 0;
+	shared_ptr<atomic<int32_t>> attempt_counter;
+	context.TryGetValue(ATTEMPT_COUNTER_KEY, attempt_counter);
+	entry.attempt = attempt_counter ? attempt_counter->fetch_add(1) : 0;
+	entry.bytes = 0;
+	entry.latency_us = 0;
+	const auto &url = request.GetUrl();
+	entry.SetHost(url.GetHost());
+	entry.SetPath("/" + url.GetPath());
+	auto range = request.GetHeader("x-ms-range");
+	if (!range.HasValue()) {
+		range = request.GetHeader("range");
+	}
+	entry.SetRange(range.HasValue() ? range.Value() : "");
+
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed_us = [start]() {
+		return static_cast<idx_t>(
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+	};
+
+	std::unique_ptr<Azure::Core::Http::RawResponse> result;
+	try {
+		result = next_policy.Send(request, context);
+	} catch (...) {
+		// Transport error, traced without status
+		entry.latency_us = elapsed_us();
+		request_log->Add(entry);
+		throw;
+	}
+	if (result == nullptr) {
+		return result;
+	}
 
+	entry.status = static_cast<int32_t>(result->GetStatusCode());
+	OnResponseFinished(*result, [entry, request_log, elapsed_us](idx_t bytes) mutable {
+		entry.bytes = bytes;
+		entry.latency_us = elapsed_us();
+		request_log->Add(entry);
+	});
 	return result;
 }
 
 std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> HttpStatePolicy::Clone() const {
-	return std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>(new HttpStatePolicy(http_state));
+	return std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>(new HttpStatePolicy(stage));
 }
 
 } // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! Concurrency and chunk size used to download a range
+struct AzureTransferSettings {
+	int32_t concurrency;
+	int64_t chunk_size;
+};
+
+//! Tunes the transfer settings of a storage account from the measured downloads. As long as the throughput
+//! and the chunk latency per byte hold, the concurrency and the chunk size are increased additively; a failure or a
+//! degradation halves them (AIMD).
+class AzureAdaptiveTransfer {
+public:
+	static constexpr int32_t MIN_CONCURRENCY = 1;
+	static constexpr int32_t MAX_CONCURRENCY = 64;
+	static constexpr int64_t MIN_CHUNK_SIZE = 256 * 1024;
+	static constexpr int64_t MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+	//! Step of the additive increase of the chunk size
+	static constexpr int64_t CHUNK_SIZE_STEP = 1024 * 1024;
+
+	explicit AzureAdaptiveTransfer(const AzureTransferSettings &initial_settings);
+
+public:
+	AzureTransferSettings GetSettings();
+	//! The settings to use for a download of `bytes`, the chunks are kept small enough for it to still be split
+	static AzureTransferSettings ForDownload(const AzureTransferSettings &settings, idx_t bytes);
+	//! Feed the outcome of a download of `bytes` done with `settings` (as returned by GetSettings) in `elapsed_us`
+	//! microseconds
+	void Record(const AzureTransferSettings &settings, idx_t bytes, int64_t elapsed_us, bool failed);
+
+private:
+	void Increase();
+	void Decrease();
+
+private:
+	mutex lock;
+	AzureTransferSettings settings;
+	//! Moving average of the throughput of the recent downloads, in bytes per microsecond
+	double average_throughput;
+	//! Lowest latency per byte of a chunk observed recently, in microseconds per byte. The chunk latency grows with
+	//! the chunk size, comparing it per byte keeps the increases of the chunk size from looking like a congestion
+	double min_chunk_latency;
+};
+
+//! Database wide registry of the adaptive transfer state of each storage account, the state outlives the queries
+class AzureAdaptiveTransferRegistry : public ObjectCacheEntry {
+public:
+	static shared_ptr<AzureAdaptiveTransferRegistry> GetRegistry(ClientContext &context);
+
+	//! Get the state of an account, created with `initial_settings` on the first call
+	shared_ptr<AzureAdaptiveTransfer> GetAccount(const std::string &account,
+	                                             const AzureTransferSettings &initial_settings);
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+private:
+	mutex lock;
+	unordered_map<std::string, shared_ptr<AzureAdaptiveTransfer>> accounts;
+};
+
+} // namespace duckdb
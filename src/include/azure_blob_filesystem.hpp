@@ -7,13 +7,16 @@
 #include "azure_filesystem.hpp"
 #include <azure/storage/blobs/blob_client.hpp>
 #include <azure/storage/blobs/blob_service_client.hpp>
+#include <azure/storage/blobs/block_blob_client.hpp>
+#include <functional>
 #include <string>
 
 namespace duckdb {
 
 class AzureBlobContextState : public AzureContextState {
 public:
-	AzureBlobContextState(Azure::Storage::Blobs::BlobServiceClient client, const AzureReadOptions &azure_read_options);
+	AzureBlobContextState(Azure::Storage::Blobs::BlobServiceClient client, const AzureReadOptions &azure_read_options,
+	                      const AzureWriteOptions &azure_write_options, shared_ptr<AzureHTTPState> http_state);
 	Azure::Storage::Blobs::BlobContainerClient GetBlobContainerClient(const std::string &blobContainerName) const;
 	~AzureBlobContextState() override = default;
 
@@ -26,11 +29,12 @@ class AzureBlobStorageFileSystem;
 class AzureBlobStorageFileHandle : public AzureFileHandle {
 public:
 	AzureBlobStorageFileHandle(AzureBlobStorageFileSystem &fs, string path, FileOpenFlags flags,
-	                           const AzureReadOptions &read_options, Azure::Storage::Blobs::BlobClient blob_client);
-	~AzureBlobStorageFileHandle() override = default;
+	                           shared_ptr<AzureContextState> storage_context,
+	                           Azure::Storage::Blobs::BlockBlobClient blob_client);
+	~AzureBlobStorageFileHandle() override;
 
 public:
-	Azure::Storage::Blobs::BlobClient blob_client;
+	Azure::Storage::Blobs::BlockBlobClient blob_client;
 };
 
 class AzureBlobStorageFileSystem : public AzureStorageFileSystem {
@@ -39,6 +43,8 @@ public:
 
 	// FS methods
 	bool FileExists(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
+	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
+	void MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener = nullptr) override;
 	bool CanHandleFile(const string &fpath) override;
 	string GetName() const override {
 		return "AzureBlobStorageFileSystem";
@@ -46,6 +52,9 @@ public:
 
 	// From AzureFilesystem
 	void LoadRemoteFileInfo(AzureFileHandle &handle) override;
+	idx_t LoadRemoteFileInfoWithRange(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len) override;
+	bool LoadRemoteFileMetadata(AzureContextState &storage_context, const string &path,
+	                            AzureFileMetadata &metadata) override;
 
 public:
 	static const string SCHEME;
@@ -64,7 +73,29 @@ protected:
 	unique_ptr<AzureFileHandle> CreateHandle(const string &path, FileOpenFlags flags,
 	                                         optional_ptr<FileOpener> opener) override;
 
-	void ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len) override;
+	void DownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                   const AzureTransferSettings &transfer, const Azure::Core::Context &context) override;
+	void UploadBlock(AzureFileHandle &handle, idx_t block_idx, idx_t file_offset, const data_t *data,
+	                 idx_t length) override;
+	void CommitUpload(AzureFileHandle &handle, idx_t block_count, idx_t length) override;
+
+private:
+	using BlobItem = Azure::Storage::Blobs::Models::BlobItem;
+
+	//! A prefix (ending with a '/') to list, and the index of the pattern segment that must match below it
+	struct BlobListingTask {
+		string prefix;
+		idx_t segment_idx;
+	};
+
+	//! Block ids must have the same length for all the blocks of a blob
+	static std::string BlockId(idx_t block_idx);
+
+	//! Flat listing of all the blobs under `prefix`, calls `on_match` for the ones matching the pattern
+	static void ListBlobs(const Azure::Storage::Blobs::BlobContainerClient &container_client, const string &prefix,
+	                      const vector<string> &pattern_splits, const Azure::Core::Context &context,
+	                      const shared_ptr<AzureHTTPState> &http_state,
+	                      const std::function<void(const BlobItem &)> &on_match);
 };
 
 } // namespace duckdb
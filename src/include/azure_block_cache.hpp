@@ -0,0 +1,85 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/buffer/block_handle.hpp"
+#include "duckdb/storage/buffer/buffer_handle.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! A block of a remote file pinned in memory while it is read
+struct AzureCachedBlock {
+	BufferHandle buffer;
+	idx_t length;
+
+	const data_t *Data() const {
+		return buffer.Ptr();
+	}
+};
+
+//! Database wide LRU cache of fixed size blocks of remote files. A block is identified by the file URL, its ETag
+//! and its index, so a modified file never returns stale data. The blocks are allocated through the buffer manager
+//! and stay unpinned in the cache: they are accounted in the database memory limit, and the buffer manager can
+//! destroy them when it needs the memory, they are then dropped by the next Get.
+class AzureBlockCache : public ObjectCacheEntry {
+public:
+	explicit AzureBlockCache(BufferManager &buffer_manager);
+
+	static shared_ptr<AzureBlockCache> GetCache(ClientContext &context);
+
+public:
+	static std::string BlockKey(const std::string &path, const std::string &etag, idx_t block_size, idx_t block_idx);
+
+	//! Returns the block pinned, or nullptr if it is not cached
+	shared_ptr<AzureCachedBlock> Get(const std::string &key);
+	//! Check if a block is cached, without updating the LRU or the counters
+	bool Contains(const std::string &key);
+	//! Copy `data` in the cache, silently skipped when there is no memory available
+	void Insert(const std::string &key, const data_t *data, idx_t length);
+	//! Update the cache capacity, evicting blocks if needed
+	void SetCapacity(idx_t capacity);
+	void Clear();
+
+	idx_t GetCapacity();
+	idx_t GetSize();
+	idx_t GetBlockCount();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+public:
+	atomic<idx_t> hit_count {0};
+	atomic<idx_t> miss_count {0};
+
+private:
+	struct CacheEntry {
+		shared_ptr<BlockHandle> block;
+		idx_t length;
+		list<std::string>::iterator lru_position;
+	};
+
+	//! Must be called with the lock held
+	void EvictUntil(idx_t target_size);
+	void Remove(unordered_map<std::string, CacheEntry>::iterator entry);
+
+private:
+
+	BufferManager &buffer_manager;
+
+	mutex lock;
+	idx_t capacity;
+	idx_t size;
+	//! Most recently used first
+	list<std::string> lru;
+	unordered_map<std::string, CacheEntry> blocks;
+};
+
+} // namespace duckdb
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+struct AzureCacheFunctions {
+public:
+	//! Register the azure_cache_stats and azure_cache_clear table functions
+	static void Register(DatabaseInstance &instance);
+};
+
+} // namespace duckdb
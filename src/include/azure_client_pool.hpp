@@ -0,0 +1,71 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <azure/storage/blobs/blob_service_client.hpp>
+#include <azure/storage/files/datalake/datalake_service_client.hpp>
+#include <functional>
+#include <string>
+
+namespace duckdb {
+
+//! Database wide pool of storage account service clients.
+//! Building a service client (transport, credential, policies) and acquiring its first token is expensive, so
+//! clients are shared between queries and connections. The pool key identifies everything used to build the
+//! client (account, endpoint, secret or settings, transport configuration), any change to one of them results
+//! in a different key and therefore in a new client. The key is the SHA-256 digest of these values, so the pool
+//! does not keep the secrets in clear, and a collision cannot hand out a client built with other credentials.
+class AzureClientPool : public ObjectCacheEntry {
+public:
+	//! Upper bound of clients kept per service type, the least recently used one is dropped beyond it
+	static constexpr idx_t MAX_POOLED_CLIENTS = 64;
+
+public:
+	//! Returns the pool of the database, or nullptr if the pooling is disabled or there is no client context
+	static shared_ptr<AzureClientPool> TryGetPool(optional_ptr<FileOpener> opener);
+
+	Azure::Storage::Blobs::BlobServiceClient
+	GetOrCreateBlobClient(const std::string &key,
+	                      const std::function<Azure::Storage::Blobs::BlobServiceClient()> &create);
+	Azure::Storage::Files::DataLake::DataLakeServiceClient
+	GetOrCreateDfsClient(const std::string &key,
+	                     const std::function<Azure::Storage::Files::DataLake::DataLakeServiceClient()> &create);
+
+	//! Drop all the pooled clients
+	void Clear();
+	idx_t GetClientCount();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+public:
+	atomic<idx_t> hit_count {0};
+	atomic<idx_t> miss_count {0};
+
+private:
+	template <class CLIENT>
+	struct PooledClients {
+		struct Entry {
+			shared_ptr<CLIENT> client;
+			list<std::string>::iterator lru_position;
+		};
+		//! Most recently used first
+		list<std::string> lru;
+		unordered_map<std::string, Entry> entries;
+	};
+
+	template <class CLIENT>
+	CLIENT GetOrCreate(PooledClients<CLIENT> &clients, const std::string &key, const std::function<CLIENT()> &create);
+
+private:
+	mutex lock;
+	PooledClients<Azure::Storage::Blobs::BlobServiceClient> blob_clients;
+	PooledClients<Azure::Storage::Files::DataLake::DataLakeServiceClient> dfs_clients;
+};
+
+} // namespace duckdb
@@ -2,6 +2,7 @@
 
 #include "azure_filesystem.hpp"
 #include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include <azure/storage/files/datalake/datalake_file_client.hpp>
@@ -15,7 +16,8 @@ namespace duckdb {
 class AzureDfsContextState : public AzureContextState {
 public:
 	AzureDfsContextState(Azure::Storage::Files::DataLake::DataLakeServiceClient client,
-	                     const AzureReadOptions &azure_read_options);
+	                     const AzureReadOptions &azure_read_options, const AzureWriteOptions &azure_write_options,
+	                     shared_ptr<AzureHTTPState> http_state);
 	Azure::Storage::Files::DataLake::DataLakeFileSystemClient
 	GetDfsFileSystemClient(const std::string &file_system_name) const;
 
@@ -28,12 +30,19 @@ class AzureDfsStorageFileSystem;
 class AzureDfsStorageFileHandle : public AzureFileHandle {
 public:
 	AzureDfsStorageFileHandle(AzureDfsStorageFileSystem &fs, string path, FileOpenFlags flags,
-	                          const AzureReadOptions &read_options,
+	                          shared_ptr<AzureContextState> storage_context,
 	                          Azure::Storage::Files::DataLake::DataLakeFileClient client);
-	~AzureDfsStorageFileHandle() override = default;
+	~AzureDfsStorageFileHandle() override;
 
 public:
 	Azure::Storage::Files::DataLake::DataLakeFileClient file_client;
+
+	//! File the appends go to: a temporary file next to the target until the first commit renames it over the
+	//! target, then the target itself. Created by the first append, a failed write never touches the target
+	unique_ptr<Azure::Storage::Files::DataLake::DataLakeFileClient> upload_client;
+	//! Path of the temporary file in its file system, empty once renamed
+	string upload_path;
+	mutex upload_lock;
 };
 
 class AzureDfsStorageFileSystem : public AzureStorageFileSystem {
@@ -45,8 +54,21 @@ public:
 		return "AzureDfsStorageFileSystem";
 	}
 
+	// FS methods
+	bool FileExists(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
+	bool DirectoryExists(const string &directory, optional_ptr<FileOpener> opener = nullptr) override;
+	void CreateDirectory(const string &directory, optional_ptr<FileOpener> opener = nullptr) override;
+	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
+	//! Atomic rename, used by COPY for its temporary files
+	void MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener = nullptr) override;
+	bool ListFiles(const string &directory, const std::function<void(const string &, bool)> &callback,
+	               FileOpener *opener = nullptr) override;
+
 	// From AzureFilesystem
 	void LoadRemoteFileInfo(AzureFileHandle &handle) override;
+	idx_t LoadRemoteFileInfoWithRange(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len) override;
+	bool LoadRemoteFileMetadata(AzureContextState &storage_context, const string &path,
+	                            AzureFileMetadata &metadata) override;
 
 public:
 	static const string SCHEME;
@@ -64,7 +86,16 @@ protected:
 	unique_ptr<AzureFileHandle> CreateHandle(const string &path, FileOpenFlags flags,
 	                                         optional_ptr<FileOpener> opener) override;
 
-	void ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len) override;
+	void DownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                   const AzureTransferSettings &transfer, const Azure::Core::Context &context) override;
+	void UploadBlock(AzureFileHandle &handle, idx_t block_idx, idx_t file_offset, const data_t *data,
+	                 idx_t length) override;
+	void CommitUpload(AzureFileHandle &handle, idx_t block_count, idx_t length) override;
+	void CleanupAbortedUpload(AzureFileHandle &handle) override;
+
+private:
+	//! Client of the file the appends go to, the temporary file is created on first use
+	Azure::Storage::Files::DataLake::DataLakeFileClient &GetUploadClient(AzureDfsStorageFileHandle &handle);
 };
 
 } // namespace duckdb
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+
+namespace duckdb {
+
+class ClientContext;
+
+enum class AzureDiskCacheEviction : uint8_t {
+	//! Evict the block that has not been read for the longest time
+	LRU,
+	//! Evict the oldest block
+	FIFO
+};
+
+//! Local disk tier of the block cache, blocks are stored as individual files in a directory so they survive
+//! the process restarts. As for the in memory cache a block key contains the file ETag and last modification
+//! time, the key is also stored in the file to detect hash collisions. A local I/O error disables the cache until
+//! it is configured with another directory, the reads then simply go to the storage account.
+//! The blocks are written by a background thread, started on demand, so the reads never wait for the local disk.
+class AzureDiskCache : public ObjectCacheEntry {
+public:
+	//! Size of the blocks waiting to be written above which the new ones are dropped
+	static constexpr idx_t MAX_PENDING_WRITE_BYTES = 64 * 1024 * 1024;
+	//! Time (in milliseconds) after which the writer thread without blocks to write exits
+	static constexpr idx_t IDLE_TIMEOUT_MS = 1000;
+
+	AzureDiskCache();
+	~AzureDiskCache() override;
+
+	static shared_ptr<AzureDiskCache> GetCache(ClientContext &context);
+	static AzureDiskCacheEviction ParseEviction(const std::string &eviction);
+
+public:
+	//! (Re)configure the cache, changing the directory drops the index of the previous one
+	void Configure(const std::string &directory, idx_t max_size, AzureDiskCacheEviction eviction);
+
+	//! Read a block, returns false if it is not cached
+	bool Read(const std::string &key, unique_ptr<data_t[]> &data, idx_t &length);
+	//! Check if a block is cached, without updating the eviction order or the counters
+	bool Contains(const std::string &key);
+	//! Queue a block to store, unless it is already cached. Errors are ignored as the cache is only an optimization
+	void Write(const std::string &key, const data_t *data, idx_t length);
+	//! Wait for the queued blocks to be written
+	void Flush();
+	void Clear();
+
+	std::string GetDirectory();
+	idx_t GetCapacity();
+	idx_t GetSize();
+	idx_t GetBlockCount();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+public:
+	atomic<idx_t> hit_count {0};
+	atomic<idx_t> miss_count {0};
+
+private:
+	struct CacheEntry {
+		idx_t size;
+		//! Position in the eviction order
+		idx_t order;
+	};
+
+	struct PendingWrite {
+		std::string key;
+		std::string file_name;
+		unique_ptr<data_t[]> data;
+		idx_t length;
+	};
+
+	static std::string FileName(const std::string &key);
+	//! Scan the cache directory on first use, must be called with the lock held
+	void LoadIndex();
+	void ScanDirectory();
+	//! Stop using the directory after an I/O error, must be called with the lock held
+	void Disable();
+	//! Must be called with the lock held
+	void EvictUntil(idx_t target_size);
+	void RemoveFile(const std::string &file_name);
+	//! Drop a block from the index and the directory, must be called with the lock held
+	void RemoveBlock(const std::string &file_name);
+	//! Store a block in the directory, called by the writer thread
+	void WriteBlock(const PendingWrite &block);
+	void WriteQueuedBlocks();
+
+private:
+	unique_ptr<FileSystem> local_fs;
+
+	mutex lock;
+	std::string directory;
+	idx_t max_size;
+	AzureDiskCacheEviction eviction;
+	bool index_loaded;
+	bool disabled;
+
+	idx_t size;
+	idx_t next_order;
+	unordered_map<std::string, CacheEntry> entries;
+	//! File names by eviction order, the first one is the next to evict
+	map<idx_t, std::string> eviction_order;
+
+	//! Blocks waiting for the writer thread, and their file names
+	std::deque<PendingWrite> pending_writes;
+	unordered_set<std::string> pending_file_names;
+	idx_t pending_write_bytes;
+	std::condition_variable writes_changed;
+	std::thread writer;
+	bool writer_running;
+	//! Whether the writer thread is writing a block taken from the queue
+	bool writing;
+	bool shutdown;
+};
+
+} // namespace duckdb
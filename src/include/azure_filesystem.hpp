@@ -1,14 +1,32 @@
 #pragma once
 
+#include "azure_adaptive_transfer.hpp"
+#include "azure_block_cache.hpp"
+#include "azure_disk_cache.hpp"
+#include "azure_http_state.hpp"
+#include "azure_in_flight_reads.hpp"
+#include "azure_latency_tracker.hpp"
+#include "azure_metadata_prefetcher.hpp"
+#include "azure_not_found_cache.hpp"
 #include "azure_parsed_url.hpp"
+#include "azure_read_ahead.hpp"
+#include "azure_read_buffer_pool.hpp"
+#include "azure_timer.hpp"
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/main/client_context_state.hpp"
+#include <azure/core/context.hpp>
 #include <azure/core/datetime.hpp>
 #include <ctime>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 
 namespace duckdb {
 
@@ -16,16 +34,88 @@ struct AzureReadOptions {
 	int32_t transfer_concurrency = 5;
 	int64_t transfer_chunk_size = 1 * 1024 * 1024;
 	idx_t buffer_size = 1 * 1024 * 1024;
+	//! Number of buffers downloaded in the background ahead of a sequential read, 0 disables the read-ahead
+	idx_t read_ahead_depth = 0;
+	//! Number of consecutive sequential buffer refills needed before starting the read-ahead
+	idx_t read_ahead_trigger = 2;
+	//! Memory available to the block cache, 0 disables the cache
+	idx_t block_cache_size = 0;
+	//! Size of the blocks kept in the block cache
+	idx_t block_cache_block_size = 1 * 1024 * 1024;
+	//! Files up to this size are downloaded at once when opened, their reads are served from memory. 0 disables it
+	idx_t small_file_threshold = 0;
+	//! Size of the end of a Parquet file fetched when it is opened, so the footer is read with a single request.
+	//! 0 disables the prefetch
+	idx_t tail_prefetch_size = 0;
+	//! Open the files without request, the file info is loaded by the first read (with its own GET when it starts
+	//! at the beginning of the file) or the first size request
+	bool lazy_open = false;
+	//! Small unbuffered reads also download up to this many following bytes, the next reads of nearby ranges are
+	//! served from the same request. 0 disables the coalescing
+	idx_t coalesce_gap = 0;
+	//! Directory of the disk cache, empty disables the disk cache
+	string disk_cache_directory;
+	//! Maximum disk space used by the disk cache
+	idx_t disk_cache_max_size = 10ULL * 1024 * 1024 * 1024;
+	AzureDiskCacheEviction disk_cache_eviction = AzureDiskCacheEviction::LRU;
+	//! Tune the transfer concurrency and chunk size of each storage account from the measured downloads, the
+	//! static values are used as a starting point
+	bool adaptive_transfer = false;
+	//! A range download slower than this percentile (0-1) of the account latencies is duplicated and the first
+	//! response is used. 0 disables the hedging
+	double hedge_percentile = 0;
+	//! Maximum fraction of the downloads that can be hedged
+	double hedge_budget = 0.05;
+};
+
+struct AzureWriteOptions {
+	//! Size of the blocks uploaded while writing a file
+	idx_t block_size = 8 * 1024 * 1024;
+	//! Maximum number of blocks uploaded concurrently by a file handle
+	idx_t upload_concurrency = 4;
+};
+
+//! File info obtained without opening the file, e.g. from a listing
+struct AzureFileMetadata {
+	idx_t length;
+	time_t last_modified;
+	string etag;
 };
 
 class AzureContextState : public ClientContextState {
 public:
 	const AzureReadOptions read_options;
+	const AzureWriteOptions write_options;
+	//! HTTP stats of the connection, null when azure_http_stats is disabled
+	const shared_ptr<AzureHTTPState> http_state;
+	//! Context given to every SDK call. The service clients are shared between connections so the
+	//! HTTP state cannot be bound to the client pipeline, instead it travels with the request context.
+	//! Completed when the storage context is initialized, constant afterward.
+	Azure::Core::Context request_context;
+	//! Database block cache, null when the cache is disabled
+	shared_ptr<AzureBlockCache> block_cache;
+	//! Database disk cache, null when the disk cache is disabled
+	shared_ptr<AzureDiskCache> disk_cache;
+	//! Transfer settings of the storage account, null when the adaptive transfer is disabled
+	shared_ptr<AzureAdaptiveTransfer> adaptive_transfer;
+	//! Latencies of the storage account, null when the hedging is disabled
+	shared_ptr<AzureLatencyTracker> latency_tracker;
+	//! Database not found cache, null when the cache is disabled
+	shared_ptr<AzureNotFoundCache> not_found_cache;
+	//! Read buffers of the handles, allocated by the buffer manager when the context has a client context
+	shared_ptr<AzureReadBufferPool> read_buffer_pool;
+	//! Background fetches of file info of the file system, the ones not started are dropped when the query ends
+	optional_ptr<AzureMetadataPrefetcher> metadata_prefetcher;
 
 public:
 	virtual bool IsValid() const;
 	void QueryEnd() override;
 
+	//! Remember the info of a listed file, opening it during the query will not need a request
+	void AddFileMetadata(const string &path, AzureFileMetadata metadata);
+	bool TryGetFileMetadata(const string &path, AzureFileMetadata &metadata) const;
+	void RemoveFileMetadata(const string &path);
+
 	template <class TARGET>
 	TARGET &As() {
 		D_ASSERT(dynamic_cast<TARGET *>(this));
@@ -38,10 +128,17 @@ public:
 	}
 
 protected:
-	AzureContextState(const AzureReadOptions &read_options);
+	AzureContextState(const AzureReadOptions &read_options, const AzureWriteOptions &write_options,
+	                  shared_ptr<AzureHTTPState> http_state);
 
 protected:
-	bool is_valid;
+	//! Also read by the background fetches of file info
+	atomic<bool> is_valid;
+
+private:
+	//! The context only lives for a query, so are the entries of this cache
+	mutable mutex metadata_lock;
+	unordered_map<string, AzureFileMetadata> file_metadata;
 };
 
 class AzureStorageFileSystem;
@@ -49,11 +146,21 @@ class AzureStorageFileSystem;
 class AzureFileHandle : public FileHandle {
 public:
 	virtual bool PostConstruct();
-	void Close() override {
-	}
+	//! Explicit close by the writer: commits what has been written
+	void Close() override;
+	//! Stop the background transfers without committing anything, for the destructors of the handles: a written
+	//! handle destroyed without an explicit FileSync or Close belongs to a write that failed
+	void Discard();
+	//! Whether the whole content of the file has been fetched when it was opened
+	bool HasWholeFile() const;
 
 protected:
-	AzureFileHandle(AzureStorageFileSystem &fs, string path, FileOpenFlags flags, const AzureReadOptions &read_options);
+	AzureFileHandle(AzureStorageFileSystem &fs, string path, FileOpenFlags flags,
+	                shared_ptr<AzureContextState> storage_context);
+
+private:
+	//! Wait for the read-ahead and give the read buffer back
+	void StopReads();
 
 public:
 	FileOpenFlags flags;
@@ -61,17 +168,53 @@ public:
 	// File info
 	idx_t length;
 	time_t last_modified;
+	string etag;
+	//! Lazily opened handle, the file info above is not loaded yet
+	bool file_info_pending;
 
-	// Read buffer
-	duckdb::unique_ptr<data_t[]> read_buffer;
+	// Read buffer, taken from the pool of the storage context by the first buffered read and given back on Close
+	AzureReadBuffer read_buffer;
 	// Read info
 	idx_t buffer_available;
 	idx_t buffer_idx;
 	idx_t file_offset;
 	idx_t buffer_start;
 	idx_t buffer_end;
+	// Read-ahead info
+	idx_t sequential_refill_count;
+	unique_ptr<AzureReadAhead> read_ahead;
+
+	// Data fetched when the file was opened, never modified afterward
+	duckdb::unique_ptr<data_t[]> prefetched_data;
+	idx_t prefetched_start;
+	idx_t prefetched_length;
+
+	// Coalesced ranges, most recent first. Protected by the lock as unbuffered reads can be done concurrently
+	struct CoalescedRange {
+		idx_t offset;
+		idx_t length;
+		duckdb::unique_ptr<data_t[]> data;
+	};
+	mutex coalesce_lock;
+	std::deque<CoalescedRange> coalesced_ranges;
+
+	// Write buffer, uploaded as a block once full
+	duckdb::unique_ptr<data_t[]> write_buffer;
+	idx_t write_buffer_length;
+	// Write info
+	idx_t block_count;
+	idx_t uploaded_length;
+	//! Length of the file when it has been committed for the last time, invalid until the first commit
+	idx_t committed_length;
+	//! Committed by Close or aborted, nothing is uploaded anymore
+	bool write_finished;
+	//! Blocks being uploaded, oldest first
+	std::deque<std::future<void>> uploads;
 
 	const AzureReadOptions read_options;
+	const AzureWriteOptions write_options;
+	//! Keep the context alive for as long as the handle, its request context is used for every request
+	const shared_ptr<AzureContextState> storage_context;
 };
 
 class AzureStorageFileSystem : public FileSystem {
@@ -82,6 +225,8 @@ public:
 
 	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override;
 	int64_t Read(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
+	void Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override;
+	int64_t Write(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
 	bool CanSeek() override {
 		return true;
 	}
@@ -97,21 +242,115 @@ public:
 	void FileSync(FileHandle &handle) override;
 
 	bool LoadFileInfo(AzureFileHandle &handle);
+	//! Fetch the info of the files in the background, with up to azure_metadata_prefetch_concurrency requests at
+	//! once, and keep it in the storage context of the query: opening the files then does not need a request.
+	//! Does nothing when the setting is 0 or the storage contexts are not cached
+	void PrefetchFileMetadata(const vector<string> &paths, optional_ptr<FileOpener> opener);
+	//! Upload what remains of a written file and commit it, called when the handle is closed
+	void FinishWrite(AzureFileHandle &handle);
+	//! Give up a written file: wait for the uploads in flight and never commit them, the previous content of the
+	//! file is left untouched
+	void AbortWrite(AzureFileHandle &handle);
 
 protected:
 	virtual duckdb::unique_ptr<AzureFileHandle> CreateHandle(const string &path, FileOpenFlags flags,
 	                                                         optional_ptr<FileOpener> opener) = 0;
-	virtual void ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len) = 0;
+	//! Read a range of the file, going through the block caches when they are enabled
+	void ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len);
+	//! Same, the requests are sent with `context` instead of the request context of the handle (e.g. to cancel them)
+	void ReadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	               const Azure::Core::Context &context);
+	//! Download a range of the file, or wait for a concurrent download of the same file covering the range
+	void FetchRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                const Azure::Core::Context &context);
+	//! Download a range of the file with the transfer settings of the storage account
+	void TransferRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                   const Azure::Core::Context &context);
+	//! Download the range, with a duplicated request if it is slower than usual
+	void HedgedDownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                         const AzureTransferSettings &transfer, const Azure::Core::Context &context);
+	//! Download a range of the file from the storage account. Must be safe to call concurrently for the same handle
+	virtual void DownloadRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                           const AzureTransferSettings &transfer, const Azure::Core::Context &context) = 0;
+
+	//! Upload the block `block_idx` of a written file, it starts at `file_offset`. Called concurrently.
+	virtual void UploadBlock(AzureFileHandle &handle, idx_t block_idx, idx_t file_offset, const data_t *data,
+	                         idx_t length) = 0;
+	//! Make the first `block_count` uploaded blocks (`length` bytes) the content of the file
+	virtual void CommitUpload(AzureFileHandle &handle, idx_t block_count, idx_t length) = 0;
+	//! Clean up what the uploads of an aborted write left behind, must not throw
+	virtual void CleanupAbortedUpload(AzureFileHandle &handle) {
+	}
 
 	virtual const string &GetContextPrefix() const = 0;
 	shared_ptr<AzureContextState> GetOrCreateStorageContext(optional_ptr<FileOpener> opener, const string &path,
 	                                                        const AzureParsedUrl &parsed_url);
+	//! Attach the database wide objects (caches...) to a newly created context
+	void InitializeStorageContext(optional_ptr<FileOpener> opener, AzureContextState &storage_context,
+	                              const AzureParsedUrl &parsed_url);
 	virtual shared_ptr<AzureContextState> CreateStorageContext(optional_ptr<FileOpener> opener, const string &path,
 	                                                           const AzureParsedUrl &parsed_url) = 0;
 
+	//! Whether the existence of the file is known without a request: listed by the current query (`metadata` is set)
+	//! or recently found missing
+	static bool TryGetKnownExistence(AzureContextState &storage_context, const string &path, bool &exists,
+	                                 AzureFileMetadata &metadata);
+	//! Keep the caches of file info consistent with what is known of the file
+	static void OnFileNotFound(AzureContextState &storage_context, const string &path);
+	static void OnFileWritten(AzureContextState &storage_context, const string &path);
+	static void OnFileRemoved(AzureContextState &storage_context, const string &path);
+
 	virtual void LoadRemoteFileInfo(AzureFileHandle &handle) = 0;
+	//! Get the info of the file with a properties request, returns false when the path is not a file. Throws the
+	//! storage errors, e.g. when the file does not exist
+	virtual bool LoadRemoteFileMetadata(AzureContextState &storage_context, const string &path,
+	                                    AzureFileMetadata &metadata) = 0;
+	//! Fetch the info of a file for the metadata prefetcher
+	void FetchFileMetadata(AzureContextState &storage_context, const string &path);
+	//! Load the file info with a GET of its first `buffer_out_len` bytes, returns the number of bytes downloaded
+	virtual idx_t LoadRemoteFileInfoWithRange(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len) = 0;
+	//! Run `load`, which loads the file info, and turn its errors into open errors. Returns false when the file does
+	//! not exist and the handle allows it
+	bool TryLoadFileInfo(AzureFileHandle &handle, const std::function<void()> &load);
+	//! Load the file info with a GET of the first `buffer_out_len` bytes, returns the number of bytes downloaded
+	idx_t LoadFileInfoWithRange(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len);
+	//! Load the file info and keep its first `prefix_size` bytes in the handle
+	void LoadFileInfoAndPrefix(AzureFileHandle &handle, idx_t prefix_size);
+	//! Load the file info of a lazily opened handle, when it is not loaded yet
+	void LoadPendingFileInfo(AzureFileHandle &handle);
+	//! First read of a lazily opened handle, loads the file info. A large read from the beginning of the file is
+	//! served by the request loading the info: returns the number of bytes read in `buffer_out`
+	idx_t ReadWithPendingFileInfo(AzureFileHandle &handle, char *buffer_out, idx_t buffer_out_len, idx_t location);
+	//! Fetch the end of the file in the handle, when the file looks like a Parquet file
+	void PrefetchTail(AzureFileHandle &handle);
+	//! Unbuffered read going through the coalesced ranges of the handle
+	void ReadCoalescedRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len);
+	//! Fill the read buffer of the handle with `length` bytes starting at the current file offset
+	void FillReadBuffer(AzureFileHandle &handle, idx_t length);
+	void ReadCachedRange(AzureFileHandle &handle, idx_t file_offset, char *buffer_out, idx_t buffer_out_len,
+	                     const Azure::Core::Context &context);
+	//! Start the upload of the write buffer, waits for the oldest upload when too many are in flight
+	void UploadWriteBuffer(AzureFileHandle &handle);
+	//! Wait until at most `max_uploads` uploads are in flight, re-throws the upload errors
+	static void WaitForUploads(AzureFileHandle &handle, idx_t max_uploads);
 	static AzureReadOptions ParseAzureReadOptions(optional_ptr<FileOpener> opener);
+	static AzureWriteOptions ParseAzureWriteOptions(optional_ptr<FileOpener> opener);
+	static shared_ptr<AzureHTTPState> GetHttpState(optional_ptr<FileOpener> opener);
+	//! Maximum number of concurrent list requests of a glob
+	static idx_t GetListConcurrency(optional_ptr<FileOpener> opener);
 	static time_t ToTimeT(const Azure::DateTime &dt);
+	static std::string BlockKey(const AzureFileHandle &handle, idx_t block_idx);
+	//! The disk cache survives the process, its key also contains the last modification time of the file
+	static std::string DiskBlockKey(const AzureFileHandle &handle, idx_t block_idx);
+
+private:
+	//! Range downloads in progress, shared by the concurrent reads of the same range
+	AzureInFlightReads in_flight_reads;
+	//! Sends the hedges of the downloads slower than usual
+	AzureTimer hedge_timer;
+	//! Background fetches of file info, shared by the queries of the database
+	AzureMetadataPrefetcher metadata_prefetcher {
+	    [this](AzureContextState &storage_context, const string &path) { FetchFileMetadata(storage_context, path); }};
 };
 
 } // namespace duckdb
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "azure_request_metrics.hpp"
 #include "duckdb/common/atomic.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/file_system.hpp"
@@ -31,6 +32,55 @@ public:
 	atomic<idx_t> total_bytes_received {0};
 	atomic<idx_t> total_bytes_sent {0};
 
+	//! Read-ahead buffers consumed by a read
+	atomic<idx_t> read_ahead_hit_count {0};
+	//! Bytes downloaded by the read-ahead that have never been read
+	atomic<idx_t> read_ahead_wasted_bytes {0};
+
+	//! List requests sent to expand globs
+	atomic<idx_t> list_count {0};
+	//! Wall time spent expanding globs, in microseconds
+	atomic<idx_t> list_time_us {0};
+
+	//! Bytes copied from the read buffers of the handles, the other bytes are downloaded in the reader buffer
+	atomic<idx_t> read_buffer_copy_bytes {0};
+	//! Reads served by the data fetched when the file was opened
+	atomic<idx_t> prefetch_hit_count {0};
+	//! Unbuffered reads served from a range downloaded by a previous read
+	atomic<idx_t> coalesced_read_count {0};
+	//! Range downloads avoided by waiting for a concurrent download of the same range
+	atomic<idx_t> deduplicated_read_count {0};
+
+	//! Existence checks and opens answered by the not found cache, without a request
+	atomic<idx_t> not_found_cache_hit_count {0};
+	//! Existence checks answered by the files listed by the query, without a request
+	atomic<idx_t> exists_from_listing_count {0};
+	//! File info fetched in the background for the files of a list
+	atomic<idx_t> metadata_prefetch_count {0};
+
+	//! Blocks read from the memory cache
+	atomic<idx_t> block_cache_hit_count {0};
+	//! Blocks read from the disk cache
+	atomic<idx_t> disk_cache_hit_count {0};
+	//! Blocks found in none of the caches and downloaded
+	atomic<idx_t> block_cache_miss_count {0};
+
+	//! Responses asking to slow down (429/503)
+	atomic<idx_t> throttled_count {0};
+	//! Time spent by the requests waiting for the account governor, in microseconds
+	atomic<idx_t> throttle_wait_us {0};
+
+	//! Duplicated range downloads, and those that finished before the original request
+	atomic<idx_t> hedge_issued_count {0};
+	atomic<idx_t> hedge_won_count {0};
+
+	//! Transfer settings chosen by the adaptive transfer for the last download, 0 when it is disabled
+	atomic<idx_t> adaptive_concurrency {0};
+	atomic<idx_t> adaptive_chunk_size {0};
+
+	//! Timings of the requests of the query, per method
+	AzureRequestHistograms method_histograms[AZURE_REQUEST_METHOD_COUNT];
+
 	//! Called by the ClientContext when the current query ends
 	void QueryEnd(ClientContext &context) override {
 		Reset();
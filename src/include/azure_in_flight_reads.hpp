@@ -0,0 +1,46 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <string>
+
+namespace duckdb {
+
+//! Table of the range downloads in progress. A read whose range is covered by a download of the same file (URL and
+//! ETag) in progress waits for it and copies its bytes instead of sending its own request, e.g. when every thread
+//! scanning a Parquet file asks for its footer at the same time.
+class AzureInFlightReads {
+public:
+	//! Read `length` bytes at `offset` of the file identified by `key` in `buffer_out`: either `fetch` downloads them
+	//! in `buffer_out`, or they are copied from a concurrent download. Returns true in the latter case
+	bool Read(const std::string &key, idx_t offset, idx_t length, char *buffer_out, const std::function<void()> &fetch);
+	//! Number of reads waiting for (or copying from) a concurrent download
+	idx_t GetWaitingReadCount();
+
+private:
+	struct Fetch {
+		idx_t offset;
+		idx_t length;
+		//! Buffer of the download, valid until all the waiters copied from it
+		const char *data;
+		bool finished = false;
+		bool failed = false;
+		idx_t waiter_count = 0;
+	};
+
+	//! Wait for a download covering the range and copy it, returns false if there is none or it failed
+	bool TryReadFromFetch(std::unique_lock<mutex> &guard, const std::string &key, idx_t offset, idx_t length,
+	                      char *buffer_out);
+
+private:
+	mutex lock;
+	std::condition_variable fetch_changed;
+	unordered_map<std::string, vector<shared_ptr<Fetch>>> fetches;
+};
+
+} // namespace duckdb
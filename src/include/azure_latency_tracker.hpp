@@ -0,0 +1,64 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! Latencies of the recent range downloads of a storage account, used to detect the slow requests worth hedging.
+//! The latency depends on the size of the range, so the samples are grouped by size class (powers of 2).
+class AzureLatencyTracker {
+public:
+	//! Samples kept per size class
+	static constexpr idx_t SAMPLES_PER_CLASS = 256;
+	//! Samples needed before a percentile of a size class is trusted
+	static constexpr idx_t MIN_SAMPLES = 20;
+
+	AzureLatencyTracker();
+
+public:
+	void Record(idx_t bytes, int64_t latency_us);
+	//! Latency of the given percentile (0-1) for ranges of this size, 0 when there are not enough samples
+	int64_t GetPercentile(idx_t bytes, double percentile);
+	//! Reserve an extra request if the hedges stay below `budget` (a fraction) of the recorded downloads
+	bool TryReserveHedge(double budget);
+
+private:
+	static idx_t SizeClass(idx_t bytes);
+
+private:
+	struct SizeClassSamples {
+		vector<int64_t> latencies;
+		//! Next sample overwritten once the buffer is full
+		idx_t next = 0;
+	};
+
+	mutex lock;
+	vector<SizeClassSamples> size_classes;
+	idx_t request_count;
+	idx_t hedge_count;
+};
+
+//! Database wide latency trackers of the storage accounts
+class AzureLatencyTrackerRegistry : public ObjectCacheEntry {
+public:
+	static shared_ptr<AzureLatencyTrackerRegistry> GetRegistry(ClientContext &context);
+
+	shared_ptr<AzureLatencyTracker> GetAccount(const std::string &account);
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+private:
+	mutex lock;
+	unordered_map<std::string, shared_ptr<AzureLatencyTracker>> accounts;
+};
+
+} // namespace duckdb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace duckdb {
+
+//! Work queue used to list a directory tree with a bounded number of concurrent list requests. Processing a task
+//! (listing a prefix/directory) can push new tasks (the sub prefixes/directories that may contain matches).
+template <class TASK>
+class AzureListingQueue {
+public:
+	using process_function_t = std::function<void(const TASK &task, AzureListingQueue<TASK> &queue)>;
+
+	AzureListingQueue(idx_t max_concurrency, process_function_t process)
+	    : max_concurrency(max_concurrency == 0 ? 1 : max_concurrency), process(std::move(process)), active(0) {
+	}
+
+public:
+	//! Schedule a task, can be called from the process function
+	void Push(TASK task) {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			tasks.push_back(std::move(task));
+		}
+		task_available.notify_one();
+	}
+
+	//! Process the tasks until none is left, the calling thread is one of the workers. The first error raised by a
+	//! task is re-thrown once all the workers are stopped.
+	void Run() {
+		vector<std::thread> workers;
+		for (idx_t i = 1; i < max_concurrency; i++) {
+			workers.emplace_back([this]() { Work(); });
+		}
+		Work();
+		for (auto &worker : workers) {
+			worker.join();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+private:
+	void Work() {
+		while (true) {
+			TASK task;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				task_available.wait(guard, [this]() { return !tasks.empty() || active == 0 || error; });
+				if (error || tasks.empty()) {
+					// Either failed, or no task left and none running that could push new ones
+					task_available.notify_all();
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+				active++;
+			}
+
+			try {
+				process(task, *this);
+			} catch (...) {
+				std::lock_guard<std::mutex> guard(lock);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				active--;
+			}
+			task_available.notify_all();
+		}
+	}
+
+private:
+	const idx_t max_concurrency;
+	process_function_t process;
+
+	std::mutex lock;
+	std::condition_variable task_available;
+	std::deque<TASK> tasks;
+	//! Number of tasks being processed
+	idx_t active;
+	std::exception_ptr error;
+};
+
+} // namespace duckdb
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace duckdb {
+
+class AzureContextState;
+
+//! Fetches the info of files with a bounded pool of background threads, e.g. for the files of a list given to a
+//! multi-file reader: opening them finds their info in the storage context, instead of sending a HEAD per file one
+//! after the other. The threads are started on demand and exit once idle.
+class AzureMetadataPrefetcher {
+public:
+	//! Fetch the info of the file at `path` and keep it in `storage_context`
+	using fetch_function_t = std::function<void(AzureContextState &storage_context, const std::string &path)>;
+
+	//! Time (in milliseconds) after which a thread without files to fetch exits
+	static constexpr idx_t IDLE_TIMEOUT_MS = 1000;
+
+	explicit AzureMetadataPrefetcher(fetch_function_t fetch);
+	~AzureMetadataPrefetcher();
+
+public:
+	//! Fetch the info of the paths in the background, with up to `concurrency` threads
+	void Schedule(const shared_ptr<AzureContextState> &storage_context, const vector<std::string> &paths,
+	              idx_t concurrency);
+	//! Wait until the info of the path has been fetched, when it is scheduled
+	void Wait(const AzureContextState &storage_context, const std::string &path);
+	//! Drop the files of the storage context not fetched yet, e.g. when its query ends
+	void Cancel(const AzureContextState &storage_context);
+
+private:
+	using file_key_t = std::pair<const AzureContextState *, std::string>;
+	struct Task {
+		shared_ptr<AzureContextState> storage_context;
+		std::string path;
+	};
+
+	void Work(idx_t worker_id);
+	//! Join the threads that exited, must be called with the lock held
+	void JoinExitedWorkers();
+
+private:
+	const fetch_function_t fetch;
+
+	mutex lock;
+	std::condition_variable task_available;
+	std::condition_variable task_finished;
+	std::deque<Task> tasks;
+	//! Files scheduled or being fetched
+	std::set<file_key_t> unfinished;
+	unordered_map<idx_t, std::thread> workers;
+	//! Threads that exited because they were idle, not joined yet
+	vector<idx_t> exited_workers;
+	idx_t next_worker_id;
+	bool shutdown;
+};
+
+} // namespace duckdb
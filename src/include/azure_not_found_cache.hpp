@@ -0,0 +1,52 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <chrono>
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! Database wide cache of the files recently found missing (404), so probing the same optional file again does
+//! not cost a request. The entries expire after a short TTL, and are dropped when the extension writes the file.
+class AzureNotFoundCache : public ObjectCacheEntry {
+public:
+	//! Beyond this number of entries the expired ones are purged, then the whole cache if none expired
+	static constexpr idx_t MAX_ENTRIES = 100000;
+
+	AzureNotFoundCache();
+
+	static shared_ptr<AzureNotFoundCache> GetCache(ClientContext &context);
+
+public:
+	void SetTTL(idx_t ttl_ms);
+	//! Whether the path has been found missing less than the TTL ago, counts a hit or a miss
+	bool Contains(const std::string &path);
+	void Add(const std::string &path);
+	void Remove(const std::string &path);
+	void Clear();
+
+	idx_t GetEntryCount();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+public:
+	atomic<idx_t> hit_count {0};
+	atomic<idx_t> miss_count {0};
+
+private:
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+	mutex lock;
+	std::chrono::milliseconds ttl;
+	//! Path -> expiration of the entry
+	unordered_map<std::string, time_point_t> expirations;
+};
+
+} // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "azure_read_buffer_pool.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include <azure/core/context.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+//! Keep the next buffers of a sequentially read file in flight in the background, so that the network latency
+//! overlaps with the processing of the current buffer.
+class AzureReadAhead {
+public:
+	//! Function used to download [offset, offset + length) into buffer, the requests are sent with `context`
+	using fetch_function_t =
+	    std::function<void(idx_t offset, char *buffer, idx_t length, const Azure::Core::Context &context)>;
+
+	//! Maximum number of downloads in flight at once for a file, the other buffers wait for a worker
+	static constexpr idx_t MAX_WORKERS = 4;
+
+	//! The buffers are taken from `pool`, each download gets a child context of `context` to cancel it
+	AzureReadAhead(fetch_function_t fetch, shared_ptr<AzureReadBufferPool> pool, Azure::Core::Context context,
+	               idx_t buffer_size, idx_t depth);
+	~AzureReadAhead();
+
+public:
+	//! Make sure that `depth` buffers following `offset` are scheduled, never past `file_length`
+	void Schedule(idx_t offset, idx_t file_length);
+	//! If the buffer starting at `offset` is scheduled wait for it and swap it with `buffer`
+	bool TryConsume(idx_t offset, idx_t length, AzureReadBuffer &buffer);
+	//! Cancel the downloads in flight and drop all the buffers, returns the number of bytes that were downloaded
+	//! (at least partially) for nothing
+	idx_t Cancel();
+
+private:
+	struct ReadAheadBuffer {
+		idx_t offset;
+		idx_t length;
+		AzureReadBuffer data;
+		Azure::Core::Context context;
+		bool started = false;
+		bool finished = false;
+		std::exception_ptr error;
+	};
+
+	void WorkerLoop();
+
+private:
+	fetch_function_t fetch;
+	shared_ptr<AzureReadBufferPool> pool;
+	const Azure::Core::Context context;
+	const idx_t buffer_size;
+	const idx_t depth;
+
+	mutex lock;
+	std::condition_variable buffer_changed;
+	//! Scheduled buffers in file order
+	std::deque<shared_ptr<ReadAheadBuffer>> buffers;
+	//! Buffers not picked by a worker yet
+	std::deque<shared_ptr<ReadAheadBuffer>> pending;
+	vector<std::thread> workers;
+	bool shutdown;
+};
+
+} // namespace duckdb
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/buffer/buffer_handle.hpp"
+
+namespace duckdb {
+
+class BufferManager;
+
+//! Read buffer of a file handle. Its memory is allocated by the buffer manager of the database, so that it counts
+//! against the memory limit, or on the heap when the handle has been opened without a client context.
+class AzureReadBuffer {
+public:
+	AzureReadBuffer();
+	AzureReadBuffer(BufferHandle handle, idx_t size);
+	AzureReadBuffer(unique_ptr<data_t[]> data, idx_t size);
+	AzureReadBuffer(AzureReadBuffer &&other) noexcept;
+	AzureReadBuffer &operator=(AzureReadBuffer &&other) noexcept;
+
+	data_t *Ptr() const {
+		return ptr;
+	}
+	idx_t Size() const {
+		return size;
+	}
+	explicit operator bool() const {
+		return ptr != nullptr;
+	}
+
+private:
+	BufferHandle handle;
+	unique_ptr<data_t[]> data;
+	data_t *ptr;
+	idx_t size;
+};
+
+//! Read buffers shared by the file handles of a query. The buffers of the closed handles are kept for the next
+//! opened ones, instead of allocating and freeing a buffer per file when scanning thousands of files. They stay pinned
+//! while idle, so they are freed when the query ends.
+class AzureReadBufferPool {
+public:
+	//! Buffers kept for reuse, the others are freed when they are released
+	static constexpr idx_t MAX_IDLE_BUFFERS = 16;
+
+	explicit AzureReadBufferPool(optional_ptr<BufferManager> buffer_manager);
+
+public:
+	//! A buffer of `size` bytes, reuses an idle buffer of the same size when there is one
+	AzureReadBuffer Allocate(idx_t size);
+	//! Give back a buffer that is not used anymore
+	void Release(AzureReadBuffer buffer);
+	//! Free the idle buffers, the buffers released afterwards are freed right away
+	void Close();
+
+private:
+	const optional_ptr<BufferManager> buffer_manager;
+	mutex lock;
+	vector<AzureReadBuffer> idle_buffers;
+	bool closed;
+};
+
+} // namespace duckdb
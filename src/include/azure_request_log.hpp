@@ -0,0 +1,87 @@
+#pragma once
+
+#include "azure_request_metrics.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! A traced HTTP request, the strings are truncated to fit the fixed size fields
+struct AzureRequestLogEntry {
+	static constexpr idx_t MAX_HOST_LENGTH = 64;
+	static constexpr idx_t MAX_PATH_LENGTH = 256;
+	static constexpr idx_t MAX_RANGE_LENGTH = 48;
+
+	timestamp_t timestamp;
+	uint64_t thread_id;
+	AzureRequestMethod method;
+	//! HTTP status, 0 when no response has been received
+	int32_t status;
+	//! 0 for the first attempt, then the retry number
+	int32_t attempt;
+	idx_t bytes;
+	idx_t latency_us;
+	char host[MAX_HOST_LENGTH];
+	char path[MAX_PATH_LENGTH];
+	char range[MAX_RANGE_LENGTH];
+
+	void SetHost(const std::string &value);
+	void SetPath(const std::string &value);
+	void SetRange(const std::string &value);
+};
+
+//! Bounded ring of the last traced requests. Nobody waits: the sequence number of a slot is also its lock, a writer
+//! drops its entry and a reader skips the slot when it is busy.
+class AzureRequestLogBuffer {
+public:
+	explicit AzureRequestLogBuffer(idx_t capacity);
+
+public:
+	void Add(const AzureRequestLogEntry &entry);
+	//! The entries in the buffer, oldest first
+	vector<AzureRequestLogEntry> Snapshot() const;
+	idx_t GetCapacity() const;
+
+private:
+	//! Set in the sequence of a slot while its entry is written or copied
+	static constexpr idx_t SLOT_BUSY = idx_t(1) << 63;
+
+	struct Slot {
+		//! 0 while empty, otherwise the position of the entry plus 1, with SLOT_BUSY while the slot is locked
+		atomic<idx_t> sequence {0};
+		AzureRequestLogEntry entry;
+	};
+
+	const idx_t capacity;
+	unique_ptr<Slot[]> slots;
+	atomic<idx_t> next_position;
+};
+
+//! Database wide request log, the buffer is replaced (and its entries dropped) when its capacity changes
+class AzureRequestLog : public ObjectCacheEntry {
+public:
+	static shared_ptr<AzureRequestLog> GetLog(ClientContext &context);
+
+	//! The buffer to write in, with the given capacity
+	shared_ptr<AzureRequestLogBuffer> GetBuffer(idx_t capacity);
+	//! The current buffer, nullptr if the log has never been enabled
+	shared_ptr<AzureRequestLogBuffer> GetCurrentBuffer();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+private:
+	mutex lock;
+	shared_ptr<AzureRequestLogBuffer> buffer;
+};
+
+} // namespace duckdb
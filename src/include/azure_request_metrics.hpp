@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! Lock-free histogram of positive integer values. The buckets are on a log scale with 4 buckets per power of 2,
+//! so a percentile is known within ~20%.
+class AzureHistogram {
+public:
+	static constexpr idx_t BUCKET_COUNT = 252;
+
+	AzureHistogram();
+
+public:
+	void Record(idx_t value);
+	void Reset();
+
+	idx_t Count() const;
+	idx_t Max() const;
+	//! Upper bound of the bucket holding the given percentile (0-1), 0 when the histogram is empty
+	idx_t Percentile(double percentile) const;
+
+private:
+	static idx_t BucketIndex(idx_t value);
+	static idx_t BucketUpperBound(idx_t bucket);
+
+private:
+	atomic<idx_t> buckets[BUCKET_COUNT];
+	atomic<idx_t> count;
+	atomic<idx_t> max;
+};
+
+//! Timings of the requests of a kind
+struct AzureRequestHistograms {
+	//! From the request being sent to the last byte of the response body of one attempt
+	AzureHistogram latency_us;
+	//! From the request being sent to the response headers of one attempt
+	AzureHistogram ttfb_us;
+	//! Response body bytes per second, only for the requests with a body
+	AzureHistogram throughput;
+
+	void Record(idx_t ttfb, idx_t latency, idx_t bytes);
+	void Reset();
+};
+
+enum class AzureRequestMethod : uint8_t { HEAD = 0, GET = 1, PUT = 2, POST = 3, OTHER = 4 };
+static constexpr idx_t AZURE_REQUEST_METHOD_COUNT = 5;
+
+const char *AzureRequestMethodToString(AzureRequestMethod method);
+
+//! Database wide request timings, per storage account (host) and method
+class AzureRequestMetrics : public ObjectCacheEntry {
+public:
+	using key_t = std::pair<std::string, AzureRequestMethod>;
+
+	static shared_ptr<AzureRequestMetrics> GetMetrics(ClientContext &context);
+
+	shared_ptr<AzureRequestHistograms> GetHistograms(const std::string &account, AzureRequestMethod method);
+	//! All the histograms, ordered by account then method
+	vector<std::pair<key_t, shared_ptr<AzureRequestHistograms>>> GetAll();
+	void Clear();
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+private:
+	mutex lock;
+	map<key_t, shared_ptr<AzureRequestHistograms>> histograms;
+};
+
+} // namespace duckdb
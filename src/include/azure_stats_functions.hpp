@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+struct AzureStatsFunctions {
+public:
+	//! Register the azure_request_stats and azure_request_log table functions
+	static void Register(DatabaseInstance &instance);
+};
+
+} // namespace duckdb
@@ -2,8 +2,10 @@
 
 #include "azure_parsed_url.hpp"
 #include "duckdb/common/file_opener.hpp"
+#include <azure/core/http/transport.hpp>
 #include <azure/storage/blobs/blob_service_client.hpp>
 #include <azure/storage/files/datalake/datalake_service_client.hpp>
+#include <memory>
 #include <string>
 
 namespace duckdb {
@@ -16,4 +18,8 @@ Azure::Storage::Files::DataLake::DataLakeServiceClient
 ConnectToDfsStorageAccount(optional_ptr<FileOpener> opener, const std::string &path,
                            const AzureParsedUrl &azure_parsed_url);
 
+//! Process wide transport used by the clients created from now on instead of the configured one, nullptr restores
+//! the `azure_transport_option_type` setting. Meant for the benchmarks, it serves the requests without a network.
+void SetAzureTransportOverride(std::shared_ptr<Azure::Core::Http::HttpTransport> transport);
+
 } // namespace duckdb
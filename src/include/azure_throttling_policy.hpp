@@ -0,0 +1,105 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <azure/core/context.hpp>
+#include <azure/core/http/http.hpp>
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/http/raw_response.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <string>
+
+namespace duckdb {
+
+class ClientContext;
+
+//! Limits the requests sent to a storage account: an in-flight cap and a token bucket. Both are shared by all the
+//! connections, so a throttling response (429/503) slows every sender down instead of each one retrying on its own.
+//! On throttling the in-flight cap is halved and the requests are paused for the delay asked by the service; each
+//! window of successful requests raises the cap by one until the configured maximum.
+class AzureAccountGovernor {
+public:
+	using clock_t = std::chrono::steady_clock;
+
+	AzureAccountGovernor(idx_t max_in_flight, double max_request_rate);
+
+public:
+	void Configure(idx_t max_in_flight, double max_request_rate);
+	//! Wait until the request can be sent, returns the time spent waiting in microseconds
+	int64_t Acquire(const Azure::Core::Context &context);
+	//! Called once the response body of an acquired request has been read (or the request failed)
+	void Release(bool throttled, std::chrono::milliseconds retry_after);
+
+	idx_t GetInFlightLimit();
+	idx_t GetInFlightCount();
+
+private:
+	//! Returns when the next request can be sent, consuming a token if it can be sent now. Lock must be held.
+	clock_t::time_point TryAcquire(clock_t::time_point now);
+
+private:
+	mutex lock;
+	std::condition_variable released;
+
+	idx_t max_in_flight;
+	//! Current cap, between 1 and max_in_flight
+	idx_t in_flight_limit;
+	idx_t in_flight;
+	//! Successful requests since the last change of the cap
+	idx_t success_count;
+
+	//! Requests per second, 0 means unlimited
+	double max_request_rate;
+	double tokens;
+	clock_t::time_point last_refill;
+
+	//! No request is sent before this point, set by throttling responses
+	clock_t::time_point paused_until;
+	//! Pause applied when the service does not say how long to wait, doubled by consecutive throttling
+	std::chrono::milliseconds backoff;
+};
+
+//! Database wide governors of the storage accounts, identified by their host
+class AzureAccountGovernors : public ObjectCacheEntry {
+public:
+	static shared_ptr<AzureAccountGovernors> GetGovernors(ClientContext &context);
+
+	//! Update the limits of all the governors, including those created later
+	void Configure(idx_t max_in_flight, double max_request_rate);
+	shared_ptr<AzureAccountGovernor> GetGovernor(const std::string &host);
+
+	static string ObjectType();
+	string GetObjectType() override;
+
+private:
+	mutex lock;
+	idx_t max_in_flight = 0;
+	double max_request_rate = 0;
+	unordered_map<std::string, shared_ptr<AzureAccountGovernor>> governors;
+};
+
+class AzureThrottlingPolicy : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+	AzureThrottlingPolicy() = default;
+
+	//! Returns a child context whose requests go through the account governors
+	static Azure::Core::Context AttachGovernors(const Azure::Core::Context &context,
+	                                            shared_ptr<AzureAccountGovernors> governors);
+	//! Delay asked by a throttling response (x-ms-retry-after-ms or Retry-After in seconds), 0 when it has none
+	static std::chrono::milliseconds GetRetryAfter(const Azure::Core::Http::RawResponse &response);
+
+	std::unique_ptr<Azure::Core::Http::RawResponse> Send(Azure::Core::Http::Request &request,
+	                                                     Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+	                                                     Azure::Core::Context const &context) const override;
+
+	std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override;
+
+private:
+	static const Azure::Core::Context::Key GOVERNORS_KEY;
+};
+
+} // namespace duckdb
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <thread>
+#include <utility>
+
+namespace duckdb {
+
+//! Runs callbacks at a deadline on a single background thread, e.g. to send the hedge of a download still in progress
+//! after a while, without a thread per download. The thread is started on demand and exits once idle.
+class AzureTimer {
+public:
+	using clock_t = std::chrono::steady_clock;
+	//! Run on the timer thread, it must be short and must not throw
+	using callback_t = std::function<void()>;
+
+	//! Time (in milliseconds) after which the thread without callbacks to run exits
+	static constexpr idx_t IDLE_TIMEOUT_MS = 1000;
+
+	AzureTimer();
+	~AzureTimer();
+
+public:
+	//! Run `callback` at `deadline` unless it is cancelled before, returns the id to cancel it
+	idx_t Schedule(clock_t::time_point deadline, callback_t callback);
+	//! Cancel a callback, waits for it when it is running: once this returns the callback is not running anymore
+	void Cancel(idx_t timer_id);
+
+private:
+	using timer_key_t = std::pair<clock_t::time_point, idx_t>;
+
+	void Work();
+
+private:
+	mutex lock;
+	std::condition_variable timers_changed;
+	std::condition_variable callback_finished;
+	//! Callbacks to run, by deadline
+	std::map<timer_key_t, callback_t> timers;
+	//! Deadline of the callbacks to run, by id
+	unordered_map<idx_t, clock_t::time_point> deadlines;
+	idx_t next_timer_id;
+	//! Id of the callback being run, 0 when none is
+	idx_t running_timer_id;
+	std::thread worker;
+	bool worker_running;
+	bool shutdown;
+};
+
+} // namespace duckdb
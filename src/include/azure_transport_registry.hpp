@@ -0,0 +1,65 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include <azure/core/context.hpp>
+#include <azure/core/http/http.hpp>
+#include <azure/core/http/transport.hpp>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace duckdb {
+
+struct AzureTransportPoolOptions {
+	//! Maximum number of requests in flight at once on the transport, 0 for unlimited
+	idx_t pool_size = 0;
+};
+
+//! Transport shared by all the clients with the same transport configuration. The connections are pooled by the
+//! SDK transport, which does not expose them: this wrapper bounds the number of requests in flight at once, and so
+//! the number of connections the SDK transport has to keep open. A request holds its slot until its body is read.
+class AzurePooledTransport : public Azure::Core::Http::HttpTransport,
+                             public std::enable_shared_from_this<AzurePooledTransport> {
+public:
+	AzurePooledTransport(std::shared_ptr<Azure::Core::Http::HttpTransport> inner, AzureTransportPoolOptions options);
+
+public:
+	std::unique_ptr<Azure::Core::Http::RawResponse> Send(Azure::Core::Http::Request &request,
+	                                                     Azure::Core::Context const &context) override;
+
+private:
+	//! Wait for a free slot, the cancellation of the context is checked when a slot is released
+	void Acquire(const Azure::Core::Context &context);
+	void Release();
+
+private:
+	const std::shared_ptr<Azure::Core::Http::HttpTransport> inner;
+	const AzureTransportPoolOptions options;
+
+	mutex lock;
+	std::condition_variable slot_released;
+	idx_t in_flight;
+};
+
+//! Process wide registry of the transports, keyed by their configuration (transport type, proxy, CA bundle, pool
+//! options), so that the connections are shared between all the storage contexts and databases
+class AzureTransportRegistry {
+public:
+	//! Beyond this number of configurations the registry is emptied, in use transports stay alive with their clients
+	static constexpr idx_t MAX_TRANSPORTS = 32;
+
+	static AzureTransportRegistry &Get();
+
+	std::shared_ptr<AzurePooledTransport>
+	GetOrCreate(const std::string &key, const AzureTransportPoolOptions &options,
+	            const std::function<std::shared_ptr<Azure::Core::Http::HttpTransport>()> &create);
+
+private:
+	mutex lock;
+	unordered_map<std::string, std::shared_ptr<AzurePooledTransport>> transports;
+};
+
+} // namespace duckdb
@@ -1,18 +1,44 @@
 #pragma once
 
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "azure_http_state.hpp"
+#include "azure_request_log.hpp"
+#include "azure_request_metrics.hpp"
 #include <azure/core/context.hpp>
 #include <azure/core/http/http.hpp>
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/core/http/raw_response.hpp>
+#include <functional>
 #include <memory>
 
 namespace duckdb {
 
 class HttpStatePolicy : public Azure::Core::Http::Policies::HttpPolicy {
 public:
-	HttpStatePolicy(shared_ptr<AzureHTTPState> http_state);
+	//! Where the policy is registered in the client pipeline
+	enum class Stage : uint8_t {
+		//! Before the retry policy: counts the operations and their bytes, as needed by the query
+		PER_OPERATION,
+		//! After the retry policy: times every attempt sent on the network in the latency histograms, and traces it
+		//! in the request log
+		PER_RETRY
+	};
+
+	explicit HttpStatePolicy(Stage stage = Stage::PER_OPERATION) : stage(stage) {
+	}
+
+	//! Returns a child context whose requests will be accounted in the given HTTP state
+	static Azure::Core::Context AttachHttpState(const Azure::Core::Context &context,
+	                                            shared_ptr<AzureHTTPState> http_state);
+	//! Returns a child context whose requests timings will be recorded in the database metrics
+	static Azure::Core::Context AttachRequestMetrics(const Azure::Core::Context &context,
+	                                                 shared_ptr<AzureRequestMetrics> request_metrics);
+	//! Returns a child context whose requests will be traced in the given request log buffer
+	static Azure::Core::Context AttachRequestLog(const Azure::Core::Context &context,
+	                                             shared_ptr<AzureRequestLogBuffer> request_log);
+	//! Returns the HTTP state attached to the context, or nullptr
+	static shared_ptr<AzureHTTPState> TryGetHttpState(const Azure::Core::Context &context);
 
 	std::unique_ptr<Azure::Core::Http::RawResponse> Send(Azure::Core::Http::Request &request,
 	                                                     Azure::Core::Http::Policies::NextHttpPolicy next_policy,
@@ -21,7 +47,30 @@ public:
 	std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override;
 
 private:
-	shared_ptr<AzureHTTPState> http_state;
+	//! Count the operation and its bytes in the HTTP state
+	std::unique_ptr<Azure::Core::Http::RawResponse>
+	SendOperation(Azure::Core::Http::Request &request, Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+	              Azure::Core::Context const &context) const;
+	//! Record the latency histograms of an attempt
+	std::unique_ptr<Azure::Core::Http::RawResponse> SendAttempt(Azure::Core::Http::Request &request,
+	                                                            Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+	                                                            Azure::Core::Context const &context) const;
+	//! Trace an attempt in the request log
+	std::unique_ptr<Azure::Core::Http::RawResponse> SendTraced(Azure::Core::Http::Request &request,
+	                                                           Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+	                                                           Azure::Core::Context const &context) const;
+
+private:
+	const Stage stage;
+
+	static const Azure::Core::Context::Key HTTP_STATE_KEY;
+	static const Azure::Core::Context::Key REQUEST_METRICS_KEY;
+	static const Azure::Core::Context::Key REQUEST_LOG_KEY;
+	//! Number of the next attempt of the operation, shared by its retries
+	static const Azure::Core::Context::Key ATTEMPT_COUNTER_KEY;
 };
 
+//! Call `on_finish` with the body size once the body of the response has been read, or dropped before its end
+void OnResponseFinished(Azure::Core::Http::RawResponse &response, std::function<void(idx_t bytes_read)> on_finish);
+
 } // namespace duckdb
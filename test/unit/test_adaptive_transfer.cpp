@@ -0,0 +1,60 @@
+// Unit tests of the tuning of the transfer settings, the downloads are simulated from a fixed latency and bandwidth.
+
+#include "catch.hpp"
+#include "azure_adaptive_transfer.hpp"
+
+using namespace duckdb;
+
+//! Duration of a download of `bytes` with `settings` over a link with a fixed request latency and bandwidth
+static int64_t SimulateDownload(const AzureTransferSettings &settings, idx_t bytes) {
+	constexpr int64_t REQUEST_LATENCY_US = 10000;
+	constexpr int64_t BYTES_PER_US = 100;
+	auto download_settings = AzureAdaptiveTransfer::ForDownload(settings, bytes);
+	auto chunk_count = (bytes + download_settings.chunk_size - 1) / download_settings.chunk_size;
+	auto round_count = (chunk_count + download_settings.concurrency - 1) / download_settings.concurrency;
+	return static_cast<int64_t>(round_count) * (REQUEST_LATENCY_US + download_settings.chunk_size / BYTES_PER_US);
+}
+
+TEST_CASE("Adaptive transfer keeps growing while the network holds", "[azure]") {
+	AzureAdaptiveTransfer transfer({1, AzureAdaptiveTransfer::MIN_CHUNK_SIZE});
+	const idx_t download_size = 256 * 1024 * 1024;
+	for (idx_t download = 0; download < 32; download++) {
+		auto settings = transfer.GetSettings();
+		transfer.Record(settings, download_size, SimulateDownload(settings, download_size), false);
+		// Bigger chunks take longer, that alone is not a congestion
+		auto tuned_settings = transfer.GetSettings();
+		REQUIRE(tuned_settings.concurrency == settings.concurrency + 1);
+		REQUIRE(tuned_settings.chunk_size == settings.chunk_size + AzureAdaptiveTransfer::CHUNK_SIZE_STEP);
+	}
+}
+
+TEST_CASE("Adaptive transfer halves the settings on a degradation", "[azure]") {
+	AzureAdaptiveTransfer transfer({8, 8 * 1024 * 1024});
+	const idx_t download_size = 64 * 1024 * 1024;
+	auto settings = transfer.GetSettings();
+	transfer.Record(settings, download_size, SimulateDownload(settings, download_size), false);
+
+	settings = transfer.GetSettings();
+	transfer.Record(settings, download_size, 10 * SimulateDownload(settings, download_size), false);
+	auto tuned_settings = transfer.GetSettings();
+	CHECK(tuned_settings.concurrency == settings.concurrency / 2);
+	CHECK(tuned_settings.chunk_size == settings.chunk_size / 2);
+
+	// A failure too, down to the minimums
+	for (idx_t failure = 0; failure < 16; failure++) {
+		transfer.Record(transfer.GetSettings(), download_size, 0, true);
+	}
+	tuned_settings = transfer.GetSettings();
+	CHECK(tuned_settings.concurrency == AzureAdaptiveTransfer::MIN_CONCURRENCY);
+	CHECK(tuned_settings.chunk_size == AzureAdaptiveTransfer::MIN_CHUNK_SIZE);
+}
+
+TEST_CASE("Adaptive transfer does not let a small download shrink the chunks of the account", "[azure]") {
+	AzureAdaptiveTransfer transfer({4, 4 * 1024 * 1024});
+	const idx_t small_download_size = 600 * 1024;
+	auto settings = transfer.GetSettings();
+	// The small download is still split in two
+	CHECK(AzureAdaptiveTransfer::ForDownload(settings, small_download_size).chunk_size == 300 * 1024);
+	transfer.Record(settings, small_download_size, SimulateDownload(settings, small_download_size), false);
+	CHECK(transfer.GetSettings().chunk_size == settings.chunk_size + AzureAdaptiveTransfer::CHUNK_SIZE_STEP);
+}
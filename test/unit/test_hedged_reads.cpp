@@ -0,0 +1,107 @@
+// Unit tests of the hedged range downloads. The blobs are served by the mock transport of the benchmark, which makes
+// some downloads slow on demand, something a live storage account cannot do.
+
+#include "catch.hpp"
+#include "azure_http_state.hpp"
+#include "azure_storage_account_client.hpp"
+#include "azure_timer.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/extension_helper.hpp"
+#include "mock_http_transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace duckdb;
+
+TEST_CASE("Timer runs the callbacks at their deadline unless cancelled", "[azure]") {
+	AzureTimer timer;
+	std::atomic<int> run_count(0);
+	auto now = AzureTimer::clock_t::now();
+	timer.Schedule(now + std::chrono::milliseconds(10), [&]() { run_count++; });
+	auto cancelled_id = timer.Schedule(now + std::chrono::seconds(60), [&]() { run_count += 100; });
+	timer.Cancel(cancelled_id);
+	while (run_count == 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// Once Cancel returns the running callback is done
+	std::atomic<bool> started(false);
+	std::atomic<bool> finished(false);
+	auto running_id = timer.Schedule(AzureTimer::clock_t::now(), [&]() {
+		started = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		finished = true;
+	});
+	while (!started) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	timer.Cancel(running_id);
+	CHECK(finished);
+	CHECK(run_count == 1);
+
+	// The thread exits once idle and is started again by the next callback
+	std::this_thread::sleep_for(std::chrono::milliseconds(AzureTimer::IDLE_TIMEOUT_MS + 200));
+	timer.Schedule(AzureTimer::clock_t::now(), [&]() { run_count++; });
+	while (run_count == 1) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST_CASE("Slow range downloads are hedged", "[azure]") {
+	constexpr idx_t BUFFER_SIZE = 64 * 1024;
+	constexpr idx_t BUFFER_COUNT = 64;
+	auto local_fs = FileSystem::CreateLocal();
+	const std::string data_directory = "azure_unit_test_data";
+	const auto container_directory = local_fs->JoinPath(data_directory, "hedge");
+	local_fs->CreateDirectory(data_directory);
+	local_fs->CreateDirectory(container_directory);
+	vector<data_t> content(BUFFER_SIZE * BUFFER_COUNT);
+	for (idx_t byte_idx = 0; byte_idx < content.size(); byte_idx++) {
+		content[byte_idx] = static_cast<data_t>(byte_idx * 31 % 251);
+	}
+	{
+		auto file = local_fs->OpenFile(local_fs->JoinPath(container_directory, "data.bin"),
+		                               FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		file->Write(content.data(), content.size());
+	}
+
+	// One download out of four is slow, the hedge sent right after it is not
+	MockTransportOptions options;
+	options.root_directory = data_directory;
+	options.latency_us = 1000;
+	options.slow_download_interval = 4;
+	options.slow_download_latency_us = 100 * 1000;
+	auto transport = std::make_shared<MockHttpTransport>(options);
+	SetAzureTransportOverride(transport);
+	{
+		DuckDB db(nullptr);
+		ExtensionHelper::LoadAllExtensions(db);
+		Connection con(db);
+		for (auto setting : {"SET azure_account_name = 'unittest'", "SET azure_http_stats = true",
+		                     "SET azure_read_buffer_size = 65536", "SET azure_read_hedge_percentile = 0.5",
+		                     "SET azure_read_hedge_budget = 1"}) {
+			REQUIRE(!con.Query(setting)->HasError());
+		}
+		// Not a query: open a transaction like a query would, for the secret and setting lookups
+		con.BeginTransaction();
+
+		auto &fs = FileSystem::GetFileSystem(*con.context);
+		auto handle = fs.OpenFile("azure://hedge/data.bin", FileFlags::FILE_FLAGS_READ);
+		vector<data_t> read_content(content.size());
+		for (idx_t buffer_idx = 0; buffer_idx < BUFFER_COUNT; buffer_idx++) {
+			handle->Read(read_content.data() + buffer_idx * BUFFER_SIZE, BUFFER_SIZE);
+		}
+		CHECK(read_content == content);
+
+		auto http_state = AzureHTTPState::TryGetState(*con.context);
+		REQUIRE(http_state);
+		CHECK(http_state->hedge_issued_count.load() > 0);
+		CHECK(http_state->hedge_won_count.load() > 0);
+		handle.reset();
+		con.Commit();
+	}
+	SetAzureTransportOverride(nullptr);
+	local_fs->RemoveDirectory(data_directory);
+}
@@ -0,0 +1,120 @@
+// Unit tests of the sharing of concurrent range downloads. The first download is blocked until the concurrent read
+// waits for it, which the scans of a live storage account cannot guarantee.
+
+#include "catch.hpp"
+#include "azure_in_flight_reads.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace duckdb;
+
+//! A download that does not finish before it is released
+class BlockedFetch {
+public:
+	void Wait() {
+		std::unique_lock<mutex> guard(lock);
+		started = true;
+		changed.notify_all();
+		changed.wait(guard, [&]() { return released; });
+	}
+	void WaitStarted() {
+		std::unique_lock<mutex> guard(lock);
+		changed.wait(guard, [&]() { return started; });
+	}
+	void Release() {
+		lock_guard<mutex> guard(lock);
+		released = true;
+		changed.notify_all();
+	}
+
+private:
+	mutex lock;
+	std::condition_variable changed;
+	bool started = false;
+	bool released = false;
+};
+
+static void WaitForWaitingReads(AzureInFlightReads &reads, idx_t count) {
+	while (reads.GetWaitingReadCount() != count) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST_CASE("A read covered by a download in progress copies its bytes", "[azure]") {
+	AzureInFlightReads reads;
+	BlockedFetch blocked_fetch;
+	const std::string file = "abcdefghijklmnopqrstuvwxyz";
+	char first_buffer[26];
+	bool first_shared = true;
+	std::thread first_read([&]() {
+		first_shared = reads.Read("file\netag", 0, file.size(), first_buffer, [&]() {
+			memcpy(first_buffer, file.data(), file.size());
+			blocked_fetch.Wait();
+		});
+	});
+	blocked_fetch.WaitStarted();
+
+	// A range outside of the download in progress is downloaded right away
+	char other_buffer[4];
+	bool other_fetched = false;
+	REQUIRE(!reads.Read("file\netag", 100, 4, other_buffer, [&]() { other_fetched = true; }));
+	REQUIRE(other_fetched);
+	// And so is the same range of another version of the file
+	other_fetched = false;
+	REQUIRE(!reads.Read("file\nother_etag", 0, 4, other_buffer, [&]() { other_fetched = true; }));
+	REQUIRE(other_fetched);
+
+	char second_buffer[4];
+	bool second_fetched = false;
+	bool second_shared = false;
+	std::thread second_read([&]() {
+		second_shared = reads.Read("file\netag", 10, 4, second_buffer, [&]() { second_fetched = true; });
+	});
+	WaitForWaitingReads(reads, 1);
+	blocked_fetch.Release();
+	first_read.join();
+	second_read.join();
+
+	CHECK(!first_shared);
+	CHECK(second_shared);
+	CHECK(!second_fetched);
+	CHECK(std::string(second_buffer, 4) == "klmn");
+	CHECK(reads.GetWaitingReadCount() == 0);
+}
+
+TEST_CASE("The reads waiting for a failed download fetch the range themselves", "[azure]") {
+	AzureInFlightReads reads;
+	BlockedFetch blocked_fetch;
+	char first_buffer[16];
+	bool first_failed = false;
+	std::thread first_read([&]() {
+		try {
+			reads.Read("file\netag", 0, 16, first_buffer, [&]() {
+				blocked_fetch.Wait();
+				throw std::runtime_error("connection reset");
+			});
+		} catch (std::runtime_error &) {
+			first_failed = true;
+		}
+	});
+	blocked_fetch.WaitStarted();
+
+	char second_buffer[4];
+	bool second_fetched = false;
+	bool second_shared = true;
+	std::thread second_read([&]() {
+		second_shared = reads.Read("file\netag", 4, 4, second_buffer, [&]() { second_fetched = true; });
+	});
+	WaitForWaitingReads(reads, 1);
+	blocked_fetch.Release();
+	first_read.join();
+	second_read.join();
+
+	CHECK(first_failed);
+	CHECK(!second_shared);
+	CHECK(second_fetched);
+}
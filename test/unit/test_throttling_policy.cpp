@@ -0,0 +1,109 @@
+// Unit tests of the account governor and of the throttling policy. Throttling cannot be triggered on Azurite, so
+// these run without any storage account.
+
+#include "catch.hpp"
+#include "azure_throttling_policy.hpp"
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <vector>
+
+using namespace duckdb;
+
+TEST_CASE("Governor backs off on throttling and recovers additively", "[azure]") {
+	Azure::Core::Context context;
+	AzureAccountGovernor governor(8, 0);
+	CHECK(governor.GetInFlightLimit() == 8);
+
+	// Every throttling response halves the cap, never below 1
+	for (idx_t expected_limit : {4, 2, 1, 1}) {
+		governor.Acquire(context);
+		governor.Release(true, std::chrono::milliseconds(1));
+		CHECK(governor.GetInFlightLimit() == expected_limit);
+	}
+
+	// A window of successful requests (as many as the cap) raises it by one, up to the configured maximum
+	for (idx_t limit = 1; limit < 8; limit++) {
+		for (idx_t request = 0; request < limit; request++) {
+			CHECK(governor.GetInFlightLimit() == limit);
+			governor.Acquire(context);
+			governor.Release(false, std::chrono::milliseconds(0));
+		}
+	}
+	CHECK(governor.GetInFlightLimit() == 8);
+	for (idx_t request = 0; request < 16; request++) {
+		governor.Acquire(context);
+		governor.Release(false, std::chrono::milliseconds(0));
+	}
+	CHECK(governor.GetInFlightLimit() == 8);
+	CHECK(governor.GetInFlightCount() == 0);
+}
+
+static std::chrono::milliseconds RetryAfter(const std::string &header, const std::string &value) {
+	Azure::Core::Http::RawResponse response(1, 1, Azure::Core::Http::HttpStatusCode::TooManyRequests,
+	                                        "Too Many Requests");
+	if (!header.empty()) {
+		response.SetHeader(header, value);
+	}
+	return AzureThrottlingPolicy::GetRetryAfter(response);
+}
+
+TEST_CASE("Throttling policy parses the Retry-After headers", "[azure]") {
+	CHECK(RetryAfter("x-ms-retry-after-ms", "250") == std::chrono::milliseconds(250));
+	CHECK(RetryAfter("retry-after", "3") == std::chrono::milliseconds(3000));
+	// An HTTP date is not supported, the governor uses its own backoff
+	CHECK(RetryAfter("retry-after", "Wed, 21 Oct 2015 07:28:00 GMT") == std::chrono::milliseconds(0));
+	CHECK(RetryAfter("", "") == std::chrono::milliseconds(0));
+}
+
+//! End of the pipeline, answers every request with a fixed body
+class FixedResponsePolicy : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+	explicit FixedResponsePolicy(const std::vector<uint8_t> &body) : body(body) {
+	}
+
+	std::unique_ptr<Azure::Core::Http::RawResponse> Send(Azure::Core::Http::Request &request,
+	                                                     Azure::Core::Http::Policies::NextHttpPolicy next_policy,
+	                                                     Azure::Core::Context const &context) const override {
+		std::unique_ptr<Azure::Core::Http::RawResponse> response(
+		    new Azure::Core::Http::RawResponse(1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK"));
+		response->SetBodyStream(std::unique_ptr<Azure::Core::IO::BodyStream>(
+		    new Azure::Core::IO::MemoryBodyStream(body.data(), body.size())));
+		return response;
+	}
+
+	std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override {
+		return std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>(new FixedResponsePolicy(body));
+	}
+
+private:
+	const std::vector<uint8_t> &body;
+};
+
+TEST_CASE("Throttling policy holds the governor slot until the body is read", "[azure]") {
+	std::vector<uint8_t> body(1024, 'x');
+	std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+	policies.emplace_back(new AzureThrottlingPolicy());
+	policies.emplace_back(new FixedResponsePolicy(body));
+
+	auto governors = make_shared_ptr<AzureAccountGovernors>();
+	governors->Configure(4, 0);
+	auto context = AzureThrottlingPolicy::AttachGovernors(Azure::Core::Context(), governors);
+	auto governor = governors->GetGovernor("account.blob.core.windows.net");
+
+	Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Get,
+	                                   Azure::Core::Url("https://account.blob.core.windows.net/container/blob"));
+	auto response = policies[0]->Send(request, Azure::Core::Http::Policies::NextHttpPolicy(0, policies), context);
+	// The headers are there, the body is still to be streamed
+	CHECK(governor->GetInFlightCount() == 1);
+
+	auto body_stream = response->ExtractBodyStream();
+	auto read = body_stream->ReadToEnd(context);
+	CHECK(read.size() == body.size());
+	CHECK(governor->GetInFlightCount() == 0);
+
+	// A body dropped before its end gives the slot back too
+	response = policies[0]->Send(request, Azure::Core::Http::Policies::NextHttpPolicy(0, policies), context);
+	CHECK(governor->GetInFlightCount() == 1);
+	response.reset();
+	CHECK(governor->GetInFlightCount() == 0);
+}